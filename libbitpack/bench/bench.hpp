@@ -0,0 +1,251 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <glue/types.hpp>
+#include <string>
+#include <vector>
+
+namespace glue::bench {
+/*
+ * Keeps the compiler from optimizing away a value or the stores leading up
+ * to it.
+ */
+template <typename T>
+inline void do_not_optimize(T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/*
+ * Summary of one benchmark, times are per item.
+ */
+struct Result {
+  std::string name;
+  u64 items_per_call;
+  u64 bits_per_call;  // 0 if not meaningful
+  std::size_t samples;
+  f64 min_ns;
+  f64 median_ns;
+  f64 p99_ns;
+
+  f64 items_per_sec() const noexcept { return 1e9 / median_ns; }
+  f64 bits_per_ns() const noexcept {
+    return bits_per_call / (median_ns * items_per_call);
+  }
+};
+
+/*
+ * Times a benchmark body.
+ *
+ * The body is run in batches long enough to time reliably. Each batch is
+ * one sample, sampling goes on until kMinTimeSec has elapsed and there are
+ * at least kMinSamples. min, median and p99 time per item are printed and
+ * kept in results() for JSON output.
+ *
+ * Payloads should be generated from seed() so runs are reproducible.
+ */
+class Runner final {
+ public:
+  static constexpr f64 kMinTimeSec = 0.2;
+  static constexpr f64 kMinBatchSec = 20e-6;
+  static constexpr std::size_t kMinSamples = 20;
+  static constexpr std::size_t kMaxSamples = 2000;
+  static constexpr u32 kDefaultSeed = 1337;
+
+  explicit Runner(u32 seed = kDefaultSeed) noexcept : seed_{seed} {}
+
+  u32 seed() const noexcept { return seed_; }
+  const std::vector<Result>& results() const noexcept { return results_; }
+
+  /*
+   * Called from a body that can't complete, e.g. one waiting on datagrams
+   * that never arrive. The run stops without a result, and failed() is
+   * true from then on.
+   */
+  void fail(const std::string& reason) {
+    std::printf("FAILED: %s\n", reason.c_str());
+    aborted_ = true;
+    failed_ = true;
+  }
+
+  bool failed() const noexcept { return failed_; }
+
+  template <std::invocable Fn>
+  void run(const std::string& name, u64 items_per_call, Fn&& fn) {
+    run(name, items_per_call, 0, std::forward<Fn>(fn));
+  }
+
+  /*
+   * bits_per_call is the packed size one call produces or consumes, for
+   * bits/ns.
+   */
+  template <std::invocable Fn>
+  void run(const std::string& name, u64 items_per_call, u64 bits_per_call,
+           Fn&& fn) {
+    using clock = std::chrono::steady_clock;
+    const auto seconds_since = [](clock::time_point start) {
+      return std::chrono::duration<f64>(clock::now() - start).count();
+    };
+
+    aborted_ = false;
+    fn();  // warm up
+
+    u64 batch = 1;
+    for (;;) {
+      const auto start = clock::now();
+      for (u64 i = 0; i < batch && !aborted_; ++i) {
+        fn();
+      }
+      if (aborted_) {
+        return;
+      }
+      if (seconds_since(start) >= kMinBatchSec) {
+        break;
+      }
+      batch *= 2;
+    }
+
+    std::vector<f64> samples;
+    const auto start = clock::now();
+    const auto done = [&] {
+      return samples.size() >= kMaxSamples ||
+             (samples.size() >= kMinSamples &&
+              seconds_since(start) >= kMinTimeSec);
+    };
+    while (!done()) {
+      const auto batch_start = clock::now();
+      for (u64 i = 0; i < batch && !aborted_; ++i) {
+        fn();
+      }
+      if (aborted_) {
+        return;
+      }
+      samples.push_back(seconds_since(batch_start) * 1e9 /
+                        static_cast<f64>(batch * items_per_call));
+    }
+    std::sort(samples.begin(), samples.end());
+
+    const auto percentile = [&](f64 p) {
+      const auto index = static_cast<std::size_t>(p * (samples.size() - 1));
+      return samples[index];
+    };
+    Result result{name,          items_per_call,   bits_per_call,
+                  samples.size(), samples.front(), percentile(0.5),
+                  percentile(0.99)};
+    print(result);
+    results_.push_back(std::move(result));
+  }
+
+  static void print_header() {
+    std::printf("%-48s %10s %10s %10s %12s %8s\n", "benchmark", "min",
+                "median", "p99", "items/s", "bits/ns");
+  }
+
+  /*
+   * Writes results() as JSON, returns false if path can't be written.
+   */
+  bool write_json(const char* path) const {
+    std::FILE* file = std::fopen(path, "w");
+    if (file == nullptr) {
+      return false;
+    }
+
+    std::fprintf(file, "{\n  \"seed\": %u,\n  \"benchmarks\": [", seed_);
+    for (std::size_t i = 0; i < results_.size(); ++i) {
+      const auto& result = results_[i];
+      std::fprintf(file, "%s\n    {\"name\": ", i == 0 ? "" : ",");
+      write_json_string(file, result.name);
+      std::fprintf(file,
+                   ", \"items_per_call\": %llu, \"bits_per_call\": %llu, "
+                   "\"samples\": %zu",
+                   static_cast<unsigned long long>(result.items_per_call),
+                   static_cast<unsigned long long>(result.bits_per_call),
+                   result.samples);
+      write_json_number(file, "min_ns", 4, result.min_ns);
+      write_json_number(file, "median_ns", 4, result.median_ns);
+      write_json_number(file, "p99_ns", 4, result.p99_ns);
+      write_json_number(file, "items_per_sec", 1, result.items_per_sec());
+      write_json_number(file, "bits_per_ns", 4, result.bits_per_ns());
+      std::fprintf(file, "}");
+    }
+    std::fprintf(file, "\n  ]\n}\n");
+    return std::fclose(file) == 0;
+  }
+
+ private:
+  static void write_json_string(std::FILE* file, const std::string& value) {
+    std::fputc('"', file);
+    for (const char c : value) {
+      if (c == '"' || c == '\\') {
+        std::fputc('\\', file);
+        std::fputc(c, file);
+      } else if (static_cast<unsigned char>(c) < 0x20) {
+        std::fprintf(file, "\\u%04x", c);
+      } else {
+        std::fputc(c, file);
+      }
+    }
+    std::fputc('"', file);
+  }
+
+  /*
+   * JSON has no inf or nan, e.g. items_per_sec when a run took 0 ns, so
+   * those are written as null.
+   */
+  static void write_json_number(std::FILE* file, const char* key,
+                                int precision, f64 value) {
+    std::fprintf(file, ", \"%s\": ", key);
+    if (std::isfinite(value)) {
+      std::fprintf(file, "%.*f", precision, value);
+    } else {
+      std::fprintf(file, "null");
+    }
+  }
+
+  static void print(const Result& result) {
+    std::printf("%-48s %7.3f ns %7.3f ns %7.3f ns %10.3e/s",
+                result.name.c_str(), result.min_ns, result.median_ns,
+                result.p99_ns, result.items_per_sec());
+    if (result.bits_per_call > 0) {
+      std::printf(" %8.2f", result.bits_per_ns());
+    }
+    std::printf("\n");
+  }
+
+ private:
+  u32 seed_;
+  std::vector<Result> results_;
+  bool aborted_ = false;
+  bool failed_ = false;
+};
+
+using BenchmarkFn = void (*)(Runner&);
+
+struct Benchmark {
+  const char* name;
+  BenchmarkFn fn;
+};
+
+inline std::vector<Benchmark>& registry() {
+  static std::vector<Benchmark> benchmarks;
+  return benchmarks;
+}
+
+struct Registrar {
+  Registrar(const char* name, BenchmarkFn fn) {
+    registry().push_back({name, fn});
+  }
+};
+}  // namespace glue::bench
+
+/*
+ * Defines and registers a benchmark function taking a Runner&.
+ */
+#define GLUE_BENCHMARK(name)                                        \
+  static void glue_bench_##name(::glue::bench::Runner&);            \
+  static ::glue::bench::Registrar glue_bench_registrar_##name{      \
+      #name, &glue_bench_##name};                                   \
+  static void glue_bench_##name(::glue::bench::Runner& runner)
@@ -0,0 +1,78 @@
+#include <glue/bitpack/bitpack.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+
+using namespace glue;
+using namespace glue::bitpack;
+
+/*
+ * Cost of bounds checking reads.
+ *
+ * Decodes a stream of small client-input-like messages with Unpacker,
+ * which only asserts in debug, and CheckedUnpacker, which checks in
+ * release too.
+ */
+namespace {
+constexpr std::size_t kMessageCount = 16384;
+
+struct Input {
+  u32 tick;
+  u8 buttons;
+  i16 look_x;
+  i16 look_y;
+  bool jump;
+};
+
+template <CPacker TPacker>
+void pack(TPacker& packer, Input& input) {
+  pack(packer, input.tick);
+  pack_bits(packer, input.buttons, 0, 5);
+  pack_range(packer, input.look_x, -1024, 1024);
+  pack_range(packer, input.look_y, -1024, 1024);
+  pack(packer, input.jump);
+}
+
+template <typename TUnpacker>
+void bench_unpacker(bench::Runner& runner, const std::string& name,
+                    std::vector<u32>& buffer, std::vector<Input>& inputs) {
+  runner.run("checked_unpacker/" + name, inputs.size(), [&] {
+    TUnpacker unpacker{buffer};
+    for (auto& input : inputs) {
+      pack(unpacker, input);
+    }
+    if constexpr (requires { unpacker.overflowed(); }) {
+      bool overflowed = unpacker.overflowed();
+      bench::do_not_optimize(overflowed);
+    }
+    bench::do_not_optimize(inputs);
+  });
+}
+}  // namespace
+
+GLUE_BENCHMARK(checked_unpacker) {
+  std::mt19937 rng{77};
+  std::uniform_int_distribution<i32> look{-1024, 1023};
+  std::uniform_int_distribution<u32> buttons{0, 31};
+
+  std::vector<Input> inputs(kMessageCount);
+  u32 tick = 1000;
+  for (auto& input : inputs) {
+    input = {tick++, static_cast<u8>(buttons(rng)),
+             static_cast<i16>(look(rng)), static_cast<i16>(look(rng)),
+             (tick % 7) == 0};
+  }
+
+  std::vector<u32> buffer(kMessageCount * 2);
+  Packer packer{buffer};
+  for (auto& input : inputs) {
+    pack(packer, input);
+  }
+
+  auto decoded = inputs;
+  bench_unpacker<Unpacker>(runner, "Unpacker", buffer, decoded);
+  bench_unpacker<StreamUnpacker>(runner, "StreamUnpacker", buffer, decoded);
+  bench_unpacker<CheckedUnpacker>(runner, "CheckedUnpacker", buffer, decoded);
+}
@@ -0,0 +1,47 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "bench.hpp"
+
+using namespace glue;
+
+/*
+ * bench_bitpack [filter] [--json <path>] [--seed <n>]
+ *
+ * Also the main of bench_network.
+ *
+ * Runs all registered benchmarks, or only those whose name contains filter.
+ * --json also writes the results to path, for tracking across releases.
+ * Exits with 1 if a benchmark failed.
+ */
+int main(int argc, char** argv) {
+  const char* filter = "";
+  const char* json_path = nullptr;
+  u32 seed = bench::Runner::kDefaultSeed;
+
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+      json_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+      seed = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+    } else {
+      filter = argv[i];
+    }
+  }
+
+  bench::Runner runner{seed};
+  bench::Runner::print_header();
+  for (const auto& benchmark : bench::registry()) {
+    if (std::strstr(benchmark.name, filter) == nullptr) {
+      continue;
+    }
+    benchmark.fn(runner);
+  }
+
+  if (json_path != nullptr && !runner.write_json(json_path)) {
+    std::fprintf(stderr, "could not write %s\n", json_path);
+    return 1;
+  }
+  return runner.failed() ? 1 : 0;
+}
@@ -0,0 +1,201 @@
+#include <glue/bitpack/bitpack.hpp>
+#include <glue/bitpack/pack_quantize.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+
+using namespace glue;
+using namespace glue::bitpack;
+
+/*
+ * Packer/Unpacker throughput for the basic pack() overloads.
+ *
+ * Every case runs on a "random" payload drawn uniformly from runner.seed()
+ * and a "recorded" one shaped like game traffic: grid positions, small
+ * offsets, sequential ids and rarely set flags.
+ */
+namespace {
+constexpr std::size_t kCount = 16384;
+
+/*
+ * Same layout and pack() as Message in test_packet_packing.cpp.
+ */
+struct Message {
+  u32 id;
+  f32 pos_x, pos_y, pos_z;
+  bool write_value;
+  u64 value;
+};
+
+template <CPacker T>
+inline constexpr void pack(T& packer, Message& message) {
+  pack(packer, message.id);
+  pack(packer, message.pos_x);
+  pack(packer, message.pos_y);
+  pack(packer, message.pos_z);
+  if (pack(packer, message.write_value)) {
+    pack(packer, message.value);
+  }
+}
+
+struct Fundamentals {
+  u8 a;
+  u16 b;
+  u32 c;
+  u64 d;
+  i32 e;
+  f32 f;
+  f64 g;
+  bool h;
+};
+
+template <CPacker T>
+inline constexpr void pack(T& packer, Fundamentals& value) {
+  pack(packer, value.a);
+  pack(packer, value.b);
+  pack(packer, value.c);
+  pack(packer, value.d);
+  pack(packer, value.e);
+  pack(packer, value.f);
+  pack(packer, value.g);
+  pack(packer, value.h);
+}
+
+/*
+ * Times packing and unpacking every element of values with pack_one.
+ */
+template <typename T, typename PackOne>
+void bench_payload(bench::Runner& runner, const std::string& name,
+                   const std::vector<T>& values, PackOne pack_one) {
+  auto input = values;
+  auto output = values;
+  const auto pack_all = [&](auto& packer, std::vector<T>& elements) {
+    for (auto& element : elements) {
+      pack_one(packer, element);
+    }
+  };
+
+  const std::size_t bits =
+      measure_bits([&](auto& measurer) { pack_all(measurer, input); });
+  std::vector<u32> buffer(bits / 32 + 1);
+
+  runner.run(name + "/write", values.size(), bits, [&] {
+    Packer packer{buffer};
+    pack_all(packer, input);
+    bench::do_not_optimize(buffer);
+  });
+  runner.run(name + "/read", values.size(), bits, [&] {
+    Unpacker unpacker{buffer};
+    pack_all(unpacker, output);
+    bench::do_not_optimize(output);
+  });
+}
+
+template <typename Fn>
+auto generate(std::size_t count, Fn&& make) {
+  std::vector<decltype(make(std::size_t{}))> values;
+  values.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    values.push_back(make(i));
+  }
+  return values;
+}
+
+/*
+ * x or z of a cube in a WorldFrame::init style grid, plus a little jitter.
+ */
+f32 grid_coordinate(std::mt19937& rng, std::size_t i) {
+  std::normal_distribution<f32> jitter{0.0f, 0.05f};
+  return -96.0f + 3.0f * static_cast<f32>(i % 64) + jitter(rng);
+}
+}  // namespace
+
+GLUE_BENCHMARK(pack_fundamentals) {
+  std::mt19937_64 rng{runner.seed()};
+  std::uniform_real_distribution<f64> real{-1e6, 1e6};
+  const auto values = generate(kCount, [&](std::size_t) {
+    return Fundamentals{static_cast<u8>(rng()),  static_cast<u16>(rng()),
+                        static_cast<u32>(rng()), rng(),
+                        static_cast<i32>(rng()), static_cast<f32>(real(rng)),
+                        real(rng),               (rng() & 1) != 0};
+  });
+  bench_payload(runner, "pack_fundamentals/random", values,
+                [](auto& packer, Fundamentals& value) { pack(packer, value); });
+}
+
+GLUE_BENCHMARK(pack_bits) {
+  std::mt19937 rng{runner.seed()};
+  std::uniform_int_distribution<u32> index{0, 2047};
+  const auto random = generate(kCount, [&](std::size_t) { return index(rng); });
+
+  // active cube indices: sorted, in clumps
+  std::geometric_distribution<u32> gap{0.3};
+  u32 last = 0;
+  const auto recorded = generate(kCount, [&](std::size_t) {
+    last = (last + gap(rng)) % 2048;
+    return last;
+  });
+
+  const auto pack_one = [](auto& packer, u32& value) {
+    pack_bits(packer, value, 0, 11);
+  };
+  bench_payload(runner, "pack_bits/random", random, pack_one);
+  bench_payload(runner, "pack_bits/recorded", recorded, pack_one);
+}
+
+GLUE_BENCHMARK(pack_range) {
+  std::mt19937 rng{runner.seed()};
+  std::uniform_int_distribution<i32> uniform{-4096, 4095};
+  std::normal_distribution<f32> small{0.0f, 12.0f};
+  const auto random =
+      generate(kCount, [&](std::size_t) { return uniform(rng); });
+  const auto recorded = generate(kCount, [&](std::size_t) {
+    return std::clamp(static_cast<i32>(small(rng)), -4096, 4095);
+  });
+
+  const auto pack_one = [](auto& packer, i32& value) {
+    pack_range(packer, value, -4096, 4096);
+  };
+  bench_payload(runner, "pack_range/random", random, pack_one);
+  bench_payload(runner, "pack_range/recorded", recorded, pack_one);
+}
+
+GLUE_BENCHMARK(pack_quantize) {
+  std::mt19937 rng{runner.seed()};
+  std::uniform_real_distribution<f32> uniform{-256.0f, 256.0f};
+  const auto random =
+      generate(kCount, [&](std::size_t) { return uniform(rng); });
+  const auto recorded = generate(
+      kCount, [&](std::size_t i) { return grid_coordinate(rng, i); });
+
+  const auto pack_one = [](auto& packer, f32& value) {
+    pack_quantize(packer, value, -256.0f, 256.0f, 16);
+  };
+  bench_payload(runner, "pack_quantize/random", random, pack_one);
+  bench_payload(runner, "pack_quantize/recorded", recorded, pack_one);
+}
+
+GLUE_BENCHMARK(pack_message) {
+  std::mt19937_64 rng{runner.seed()};
+  std::uniform_real_distribution<f32> position{-256.0f, 256.0f};
+  const auto random = generate(kCount, [&](std::size_t) {
+    return Message{static_cast<u32>(rng()), position(rng), position(rng),
+                   position(rng), (rng() & 1) != 0, rng()};
+  });
+
+  std::mt19937 recorded_rng{runner.seed()};
+  std::bernoulli_distribution has_value{0.1};
+  const auto recorded = generate(kCount, [&](std::size_t i) {
+    return Message{static_cast<u32>(i), grid_coordinate(recorded_rng, i),
+                   0.5f, grid_coordinate(recorded_rng, i / 64),
+                   has_value(recorded_rng), i};
+  });
+
+  const auto pack_one = [](auto& packer, Message& message) {
+    pack(packer, message);
+  };
+  bench_payload(runner, "pack_message/random", random, pack_one);
+  bench_payload(runner, "pack_message/recorded", recorded, pack_one);
+}
@@ -0,0 +1,89 @@
+#include <glue/bitpack/bitpack.hpp>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+
+using namespace glue;
+using namespace glue::bitpack;
+
+/*
+ * Span kernels vs. the per-element pack_bits loop.
+ *
+ * Payload mirrors WorldFrame::active_cubes: up to 65536 u16 indices.
+ */
+namespace {
+constexpr std::size_t kValueCount = 65536;
+
+std::vector<u16> random_values(u32 seed, u32 bits) {
+  std::mt19937 rng{seed};
+  std::uniform_int_distribution<u32> dist{0, (1u << bits) - 1};
+
+  std::vector<u16> values(kValueCount);
+  for (auto& value : values) {
+    value = static_cast<u16>(dist(rng));
+  }
+  return values;
+}
+
+template <typename TPacker, typename TUnpacker>
+void bench_width(bench::Runner& runner, const std::string& packer_name,
+                 u32 bits) {
+  auto values = random_values(runner.seed(), bits);
+  std::vector<u16> unpacked(values.size());
+  std::vector<u32> buffer((kValueCount * bits + 31) / 32 + 1);
+
+  const auto name = [&](const char* what) {
+    return packer_name + "/" + what + "/" + std::to_string(bits) + "bit";
+  };
+
+  runner.run(name("write_loop"), kValueCount, [&] {
+    TPacker packer{buffer};
+    for (auto& value : values) {
+      pack_bits(packer, value, 0, bits);
+    }
+    if constexpr (requires { packer.flush(); }) {
+      packer.flush();
+    }
+    bench::do_not_optimize(buffer);
+  });
+
+  runner.run(name("write_span"), kValueCount, [&] {
+    TPacker packer{buffer};
+    pack_bits(packer, std::span<const u16>{values}, 0, bits);
+    if constexpr (requires { packer.flush(); }) {
+      packer.flush();
+    }
+    bench::do_not_optimize(buffer);
+  });
+
+  runner.run(name("read_loop"), kValueCount, [&] {
+    TUnpacker unpacker{buffer};
+    for (auto& value : unpacked) {
+      pack_bits(unpacker, value, 0, bits);
+    }
+    bench::do_not_optimize(unpacked);
+  });
+
+  runner.run(name("read_span"), kValueCount, [&] {
+    TUnpacker unpacker{buffer};
+    pack_bits(unpacker, std::span<u16>{unpacked}, 0, bits);
+    bench::do_not_optimize(unpacked);
+  });
+}
+
+template <typename TPacker, typename TUnpacker>
+void bench_widths(bench::Runner& runner, const std::string& packer_name) {
+  for (u32 bits : {1u, 11u, 16u}) {
+    bench_width<TPacker, TUnpacker>(runner, packer_name, bits);
+  }
+}
+}  // namespace
+
+GLUE_BENCHMARK(pack_bits_span) {
+  bench_widths<Packer, Unpacker>(runner, "pack_bits_span/Packer");
+  bench_widths<StreamPacker, StreamUnpacker>(runner,
+                                             "pack_bits_span/StreamPacker");
+}
@@ -0,0 +1,149 @@
+#include <cstdio>
+#include <glue/bitpack/bitpack.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+
+using namespace glue;
+using namespace glue::bitpack;
+
+/*
+ * Variable length codes vs. fixed width on realistic streams.
+ *
+ * Header stream mirrors network::PacketHeader {index, receipt_index,
+ * receipt_flags}: index is sent as a delta from the previous packet and
+ * receipt_index as the lag behind index, which is what a sender would do
+ * with pack_varint.
+ *
+ * Delta stream mirrors baseline-delta positions in 1/256 m units: mostly
+ * small moves, sometimes a teleport.
+ */
+namespace {
+constexpr std::size_t kHeaderCount = 16384;
+constexpr std::size_t kDeltaCount = 65536;
+
+struct Header {
+  u32 index;
+  u32 receipt_index;
+  u32 receipt_flags;
+};
+
+std::vector<Header> header_stream() {
+  std::mt19937 rng{2024};
+  std::bernoulli_distribution dropped{0.02};
+  std::geometric_distribution<u32> lag{0.6};
+  std::uniform_int_distribution<u32> start{0, 1u << 30};
+
+  std::vector<Header> headers(kHeaderCount);
+  u32 index = start(rng);
+  for (auto& header : headers) {
+    index += dropped(rng) ? 2 : 1;
+    header.index = index;
+    header.receipt_index = index - 1 - lag(rng);
+    header.receipt_flags = 0xffffffffu;
+  }
+  return headers;
+}
+
+std::vector<i32> delta_stream() {
+  std::mt19937 rng{4096};
+  std::normal_distribution<f32> move{0.0f, 24.0f};
+  std::bernoulli_distribution teleport{0.005};
+  std::uniform_int_distribution<i32> far{-(1 << 20), 1 << 20};
+
+  std::vector<i32> deltas(kDeltaCount);
+  for (auto& delta : deltas) {
+    delta = teleport(rng) ? far(rng) : static_cast<i32>(move(rng));
+  }
+  return deltas;
+}
+
+template <typename Code>
+u64 header_bits(const std::vector<Header>& headers, Code code) {
+  u64 bits = 0;
+  u32 previous = headers.front().index - 1;
+  for (const auto& header : headers) {
+    bits += varint_bits(header.index - previous, code);
+    bits += varint_bits(header.index - header.receipt_index, code);
+    bits += 32;  // receipt_flags stays a bitfield
+    previous = header.index;
+  }
+  return bits;
+}
+
+template <typename Code>
+u64 delta_bits(const std::vector<i32>& deltas, Code code) {
+  u64 bits = 0;
+  for (i32 delta : deltas) {
+    bits += varint_bits(delta, code);
+  }
+  return bits;
+}
+
+void print_size(const char* stream, const char* code, u64 bits, u64 fixed,
+                std::size_t count) {
+  std::printf("%-24s %-14s %8.2f bits/item %6.1f%% of fixed\n", stream, code,
+              static_cast<f64>(bits) / count, 100.0 * bits / fixed);
+}
+
+template <typename Code>
+void bench_code(bench::Runner& runner, const std::vector<i32>& deltas,
+                const char* code_name, Code code) {
+  std::vector<u32> buffer((deltas.size() * 64 + 31) / 32);
+  std::vector<i32> unpacked(deltas.size());
+
+  runner.run(std::string{"pack_varint/write/"} + code_name, deltas.size(),
+             [&] {
+               StreamPacker packer{buffer};
+               for (i32 delta : deltas) {
+                 pack_varint(packer, delta, code);
+               }
+               packer.flush();
+               bench::do_not_optimize(buffer);
+             });
+
+  runner.run(std::string{"pack_varint/read/"} + code_name, deltas.size(),
+             [&] {
+               StreamUnpacker unpacker{buffer};
+               for (auto& delta : unpacked) {
+                 pack_varint(unpacker, delta, code);
+               }
+               bench::do_not_optimize(unpacked);
+             });
+}
+}  // namespace
+
+GLUE_BENCHMARK(pack_varint) {
+  const auto headers = header_stream();
+  const auto deltas = delta_stream();
+
+  const u64 header_fixed = headers.size() * 3 * 32;
+  print_size("PacketHeader", "fixed", header_fixed, header_fixed,
+             headers.size());
+  print_size("PacketHeader", "ExpGolomb<0>",
+             header_bits(headers, ExpGolomb<0>{}), header_fixed,
+             headers.size());
+  print_size("PacketHeader", "ExpGolomb<1>",
+             header_bits(headers, ExpGolomb<1>{}), header_fixed,
+             headers.size());
+  print_size("PacketHeader", "Chunked<3>", header_bits(headers, Chunked<3>{}),
+             header_fixed, headers.size());
+
+  const u64 delta_fixed = deltas.size() * 32;
+  print_size("position delta", "fixed", delta_fixed, delta_fixed,
+             deltas.size());
+  print_size("position delta", "ExpGolomb<0>",
+             delta_bits(deltas, ExpGolomb<0>{}), delta_fixed, deltas.size());
+  print_size("position delta", "ExpGolomb<4>",
+             delta_bits(deltas, ExpGolomb<4>{}), delta_fixed, deltas.size());
+  print_size("position delta", "Chunked<4>", delta_bits(deltas, Chunked<4>{}),
+             delta_fixed, deltas.size());
+  print_size("position delta", "Chunked<7>", delta_bits(deltas, Chunked<7>{}),
+             delta_fixed, deltas.size());
+
+  bench_code(runner, deltas, "ExpGolomb<0>", ExpGolomb<0>{});
+  bench_code(runner, deltas, "ExpGolomb<4>", ExpGolomb<4>{});
+  bench_code(runner, deltas, "Chunked<7>", Chunked<7>{});
+}
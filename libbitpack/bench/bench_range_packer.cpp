@@ -0,0 +1,155 @@
+#include <cstdio>
+#include <glue/bitpack/bitpack.hpp>
+#include <glue/bitpack/pack_pose.hpp>
+#include <glue/bitpack/range_packer.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+
+using namespace glue;
+using namespace glue::bitpack;
+
+/*
+ * RangePacker vs. Packer on WorldFrame snapshots.
+ *
+ * Items are uncompressed bytes, so Mitems/s reads as MB/s of snapshot data.
+ *
+ * Frames are laid out like WorldFrame::init: a grid of resting cubes on the
+ * ground, a few of which get knocked around each frame. A snapshot is the
+ * frame index, the active_cubes list and every cube pose.
+ */
+namespace {
+constexpr std::size_t kGridWidth = 64;
+constexpr std::size_t kCubeCount = kGridWidth * kGridWidth + 1;
+constexpr std::size_t kFrameCount = 16;
+constexpr f32 kCubeWidth = 0.5f;
+
+using Quantize = QuantizePose<16, 9>;
+const Quantize kQuantize{vec3{-256.0f, 0.0f, -256.0f},
+                         vec3{256.0f, 64.0f, 256.0f}};
+
+struct Frame {
+  u32 index;
+  std::vector<Pose> cubes;
+  std::vector<u16> active_cubes;
+};
+
+std::vector<Frame> recorded_frames() {
+  std::mt19937 rng{31337};
+  std::uniform_int_distribution<std::size_t> pick{1, kCubeCount - 1};
+  std::normal_distribution<f32> nudge{0.0f, 0.3f};
+  std::normal_distribution<f32> axis{0.0f, 1.0f};
+
+  Frame frame{0, {}, {}};
+  frame.cubes.reserve(kCubeCount);
+  frame.cubes.push_back(Pose{vec3{0.0f, 1.0f, 0.0f}, glm::identity<quat>()});
+
+  const f32 spacing = 6.0f * kCubeWidth;
+  const vec3 start = -spacing * 0.5f * vec3{kGridWidth, 0, kGridWidth} +
+                     vec3{0, kCubeWidth, 0};
+  for (std::size_t i = 0; i < kGridWidth; ++i) {
+    for (std::size_t j = 0; j < kGridWidth; ++j) {
+      frame.cubes.push_back(Pose{start + spacing * vec3{i, 0, j},
+                                 glm::identity<quat>()});
+    }
+  }
+
+  std::vector<Frame> frames;
+  for (u32 index = 0; index < kFrameCount; ++index) {
+    frame.index = index;
+    frame.active_cubes.clear();
+    frame.active_cubes.push_back(0);
+    for (int i = 0; i < 64; ++i) {
+      const auto cube = static_cast<u16>(pick(rng));
+      auto& pose = frame.cubes[cube];
+      pose.position += vec3{nudge(rng), std::abs(nudge(rng)), nudge(rng)};
+      pose.rotation = glm::normalize(
+          quat{axis(rng), axis(rng), axis(rng), axis(rng)});
+      frame.active_cubes.push_back(cube);
+    }
+    frames.push_back(frame);
+  }
+  return frames;
+}
+
+template <CPacker TPacker>
+void pack_frame(TPacker& packer, Frame& frame) {
+  pack(packer, frame.index);
+
+  u32 active_count = static_cast<u32>(frame.active_cubes.size());
+  pack_range(packer, active_count, u32{0}, u32{kCubeCount + 1});
+  frame.active_cubes.resize(active_count);
+  for (auto& cube : frame.active_cubes) {
+    pack(packer, cube);
+  }
+
+  for (auto& pose : frame.cubes) {
+    pack(packer, pose, kQuantize);
+  }
+}
+
+std::size_t raw_bytes(std::vector<Frame>& frames) {
+  std::size_t bits = 0;
+  for (auto& frame : frames) {
+    bits += measure_bits([&](auto& measurer) { pack_frame(measurer, frame); });
+  }
+  return bits / 8;
+}
+}  // namespace
+
+GLUE_BENCHMARK(range_packer) {
+  auto frames = recorded_frames();
+  auto decoded = frames;
+  const std::size_t uncompressed = raw_bytes(frames);
+
+  std::vector<std::vector<u32>> buffers(
+      frames.size(), std::vector<u32>((uncompressed / frames.size()) / 2));
+  std::size_t compressed = 0;
+
+  runner.run("range_packer/Packer/write_bytes", uncompressed, [&] {
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+      Packer packer{buffers[i]};
+      pack_frame(packer, frames[i]);
+    }
+    bench::do_not_optimize(buffers);
+  });
+  runner.run("range_packer/Packer/read_bytes", uncompressed, [&] {
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+      Unpacker unpacker{buffers[i]};
+      pack_frame(unpacker, decoded[i]);
+    }
+    bench::do_not_optimize(decoded);
+  });
+
+  bool overflowed = false;
+  runner.run("range_packer/RangePacker/write_bytes", uncompressed, [&] {
+    compressed = 0;
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+      RangePacker packer{buffers[i]};
+      pack_frame(packer, frames[i]);
+      packer.flush();
+      overflowed |= packer.overflowed();
+      compressed += packer.size_bytes();
+    }
+    bench::do_not_optimize(buffers);
+  });
+  if (overflowed) {
+    std::printf("range_packer: frame didn't fit its buffer, skipping reads\n");
+    return;
+  }
+  runner.run("range_packer/RangePacker/read_bytes", uncompressed, [&] {
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+      RangeUnpacker unpacker{buffers[i]};
+      pack_frame(unpacker, decoded[i]);
+    }
+    bench::do_not_optimize(decoded);
+  });
+
+  std::printf("%-48s %10.1f KB/frame\n", "range_packer/Packer/size",
+              uncompressed / 1e3 / frames.size());
+  std::printf("%-48s %10.1f KB/frame %8.1f%% of Packer\n",
+              "range_packer/RangePacker/size", compressed / 1e3 / frames.size(),
+              100.0 * compressed / uncompressed);
+}
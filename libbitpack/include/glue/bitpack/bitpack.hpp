@@ -2,4 +2,5 @@
 
 #include <glue/bitpack/pack_bits.hpp>
 #include <glue/bitpack/pack_fundamental.hpp>
-#include <glue/bitpack/pack_range.hpp>
\ No newline at end of file
+#include <glue/bitpack/pack_range.hpp>
+#include <glue/bitpack/pack_varint.hpp>
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <concepts>
 #include <glue/assert.hpp>
 #include <glue/types.hpp>
+#include <type_traits>
 
 namespace glue::bitpack {
 template <std::integral V>
@@ -30,4 +31,25 @@ inline constexpr u32 bits_needed_for_range(V begin, V end) {
   const auto n{std::max(begin, end) - std::min(begin, end)};
   return bits_to_represent_n_values(n);
 }
+
+/*
+ * Zigzag mapping of signed to unsigned integers:
+ * 0 -> 0, -1 -> 1, 1 -> 2, -2 -> 3, ...
+ *
+ * Values of small magnitude map to small unsigned values regardless of sign.
+ */
+template <std::signed_integral S>
+inline constexpr std::make_unsigned_t<S> zigzag_encode(S value) noexcept {
+  using U = std::make_unsigned_t<S>;
+  constexpr auto kSignShift = sizeof(S) * 8 - 1;
+  return static_cast<U>((static_cast<U>(value) << 1) ^
+                        static_cast<U>(value >> kSignShift));
+}
+
+template <std::unsigned_integral U>
+inline constexpr std::make_signed_t<U> zigzag_decode(U value) noexcept {
+  using S = std::make_signed_t<U>;
+  const auto sign_mask = static_cast<U>(-static_cast<U>(value & 1u));
+  return static_cast<S>(static_cast<U>((value >> 1) ^ sign_mask));
+}
 }  // namespace glue::bitpack
\ No newline at end of file
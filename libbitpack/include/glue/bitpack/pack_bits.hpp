@@ -7,10 +7,13 @@
 #include <glue/bitpack/concepts.hpp>
 #include <glue/bitpack/math.hpp>
 #include <glue/bitpack/pack_fundamental.hpp>
+#include <span>
+#include <type_traits>
+#include <utility>
 
 namespace glue::bitpack {
-template <CIntegralOrRef V, std::integral B>
-inline constexpr void pack_bits_wrap(Packer& packer, V&& value, B begin,
+template <CWritePacker TPacker, CIntegralOrRef V, std::integral B>
+inline constexpr void pack_bits_wrap(TPacker& packer, V&& value, B begin,
                                      u32 bits) {
   // cannot be bothered to pack larger values right now
   glue_assert(bits <= 32);
@@ -20,8 +23,8 @@ inline constexpr void pack_bits_wrap(Packer& packer, V&& value, B begin,
   }
 }
 
-template <CIntegralOrRef V, std::integral B>
-inline constexpr void pack_bits_wrap(Unpacker& packer, V&& value, B begin,
+template <CReadPacker TPacker, CIntegralOrRef V, std::integral B>
+inline constexpr void pack_bits_wrap(TPacker& packer, V&& value, B begin,
                                      u32 bits) {
   // cannot be bothered to pack larger values right now
   glue_assert(bits <= 32);
@@ -32,16 +35,84 @@ inline constexpr void pack_bits_wrap(Unpacker& packer, V&& value, B begin,
   }
 }
 
-template <CIntegralOrRef V, std::integral B>
-inline constexpr void pack_bits(Packer& packer, V&& value, B begin, u32 bits) {
+template <CWritePacker TPacker, CIntegralOrRef V, std::integral B>
+inline constexpr void pack_bits(TPacker& packer, V&& value, B begin, u32 bits) {
   glue_assert(value >= begin);
   glue_assert((value - begin) < (1ull << bits));
   pack_bits_wrap(packer, std::forward<V>(value), begin, bits);
 }
 
-template <CIntegralOrRef V, std::integral B>
-inline constexpr void pack_bits(Unpacker& packer, V&& value, B begin,
+template <CReadPacker TPacker, CIntegralOrRef V, std::integral B>
+inline constexpr void pack_bits(TPacker& packer, V&& value, B begin,
                                 u32 bits) {
   pack_bits_wrap(packer, std::forward<V>(value), begin, bits);
 }
+
+namespace detail {
+/*
+ * Calls fn with the bit count as a compile-time constant for the common
+ * widths, so span kernels get their shifts and masks folded.
+ */
+template <typename Fn>
+inline constexpr void with_bit_count(u32 bits, Fn&& fn) {
+  switch (bits) {
+    case 1:
+      return fn(std::integral_constant<std::size_t, 1>{});
+    case 8:
+      return fn(std::integral_constant<std::size_t, 8>{});
+    case 16:
+      return fn(std::integral_constant<std::size_t, 16>{});
+    case 32:
+      return fn(std::integral_constant<std::size_t, 32>{});
+    default:
+      return fn(std::size_t{bits});
+  }
+}
+}  // namespace detail
+
+/*
+ * Span overloads. Every value is packed with the same begin and bit count.
+ *
+ * Packers providing write_bits_n / read_bits_n get a word-at-a-time kernel,
+ * any other packer falls back to a per-element loop.
+ */
+template <CWritePacker TPacker, std::integral V, std::integral B>
+inline constexpr void pack_bits(TPacker& packer, std::span<V> values, B begin,
+                                u32 bits) {
+  glue_assert(bits <= 32);
+  const auto value_at = [&](std::size_t i) {
+    glue_assert(std::cmp_greater_equal(values[i], begin));
+    glue_assert(std::cmp_less(values[i] - begin, 1ull << bits));
+    return static_cast<u32>(values[i] - begin);
+  };
+
+  if constexpr (requires { packer.write_bits_n(0, bits, value_at); }) {
+    detail::with_bit_count(bits, [&](auto count) {
+      packer.write_bits_n(values.size(), count, value_at);
+    });
+  } else {
+    for (auto& value : values) {
+      pack_bits(packer, value, begin, bits);
+    }
+  }
+}
+
+template <CReadPacker TPacker, std::integral V, std::integral B>
+inline constexpr void pack_bits(TPacker& packer, std::span<V> values, B begin,
+                                u32 bits) {
+  glue_assert(bits <= 32);
+  const auto store_at = [&](std::size_t i, u32 value) {
+    values[i] = static_cast<V>(begin + value);
+  };
+
+  if constexpr (requires { packer.read_bits_n(0, bits, store_at); }) {
+    detail::with_bit_count(bits, [&](auto count) {
+      packer.read_bits_n(values.size(), count, store_at);
+    });
+  } else {
+    for (auto& value : values) {
+      pack_bits(packer, value, begin, bits);
+    }
+  }
+}
 }  // namespace glue::bitpack
\ No newline at end of file
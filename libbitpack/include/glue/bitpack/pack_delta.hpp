@@ -0,0 +1,118 @@
+#pragma once
+
+#include <concepts>
+#include <glue/assert.hpp>
+#include <glue/bitpack/math.hpp>
+#include <glue/bitpack/pack_fundamental.hpp>
+#include <glue/types.hpp>
+#include <type_traits>
+
+namespace glue::bitpack {
+/*
+ * Baseline-delta packing.
+ *
+ * pack(packer, value, baseline) writes a single 0 bit when value equals
+ * baseline. Otherwise it writes a 1 bit followed by the change. The unpacker
+ * must pass the same baseline, e.g. the last acknowledged frame, and gets
+ * value = baseline back for unchanged values.
+ *
+ * Returns whether the value changed, like pack(bool).
+ */
+namespace detail {
+/*
+ * Integral deltas are zigzag mapped and sent in the smallest of four size
+ * classes, selected by a 2 bit prefix.
+ */
+inline constexpr u32 kDeltaClassBits = 2;
+
+template <std::integral T>
+inline constexpr u32 delta_class_bits(u32 size_class) noexcept {
+  constexpr u32 kFullBits = sizeof(T) * 8;
+  constexpr u32 kClassBits[4]{4, 8, 16, kFullBits};
+  return std::min(kClassBits[size_class], kFullBits);
+}
+
+template <std::integral T>
+inline constexpr u32 delta_size_class(std::make_unsigned_t<T> zigzag) noexcept {
+  for (u32 size_class = 0; size_class < 3; ++size_class) {
+    const u32 bits = delta_class_bits<T>(size_class);
+    if (bits >= sizeof(T) * 8 || (zigzag >> bits) == 0) {
+      return size_class;
+    }
+  }
+  return 3;
+}
+
+template <typename T>
+inline constexpr bool unchanged(const T& value, const T& baseline) {
+  return value == baseline;
+}
+
+inline bool unchanged(const Pose& value, const Pose& baseline) {
+  return value.position == baseline.position &&
+         value.rotation == baseline.rotation;
+}
+
+template <typename T>
+concept CDeltaIntegral = std::integral<T> && !std::same_as<T, bool>;
+}  // namespace detail
+
+template <CWritePacker TPacker, detail::CDeltaIntegral T>
+inline constexpr bool pack(TPacker& packer, T& value, const T& baseline) {
+  using UnsignedT = std::make_unsigned_t<T>;
+  using SignedT = std::make_signed_t<T>;
+
+  const bool changed = value != baseline;
+  pack(packer, changed);
+  if (changed) {
+    // modular difference, so deltas across wraparound stay small
+    const auto delta = static_cast<UnsignedT>(static_cast<UnsignedT>(value) -
+                                              static_cast<UnsignedT>(baseline));
+    const auto zigzag = zigzag_encode(static_cast<SignedT>(delta));
+    const u32 size_class = detail::delta_size_class<T>(zigzag);
+    packer.write_bits(size_class, detail::kDeltaClassBits);
+    detail::write_wide_bits(packer, zigzag,
+                            detail::delta_class_bits<T>(size_class));
+  }
+  return changed;
+}
+
+template <CReadPacker TPacker, detail::CDeltaIntegral T>
+inline constexpr bool pack(TPacker& packer, T& value, const T& baseline) {
+  using UnsignedT = std::make_unsigned_t<T>;
+
+  bool changed = false;
+  pack(packer, changed);
+  if (changed) {
+    const u32 size_class = packer.read_bits(detail::kDeltaClassBits);
+    const auto zigzag = static_cast<UnsignedT>(detail::read_wide_bits(
+        packer, detail::delta_class_bits<T>(size_class)));
+    const auto delta = static_cast<UnsignedT>(zigzag_decode(zigzag));
+    value = static_cast<T>(static_cast<UnsignedT>(baseline) + delta);
+  } else {
+    value = baseline;
+  }
+  return changed;
+}
+
+/*
+ * Any other type: 1 bit flag, then the value packed in full with the
+ * remaining arguments (e.g. pack(packer, pose, baseline, QuantizePose{...})).
+ */
+template <CPacker TPacker, typename T, typename... Args>
+  requires(!detail::CDeltaIntegral<T>)
+inline constexpr bool pack(TPacker& packer, T& value, const T& baseline,
+                           Args&&... args) {
+  bool changed = false;
+  if constexpr (CWritePacker<TPacker>) {
+    changed = !detail::unchanged(value, baseline);
+  }
+
+  if (pack(packer, changed)) {
+    pack(packer, value, std::forward<Args>(args)...);
+  } else {
+    value = baseline;
+  }
+  return changed;
+}
+}  // namespace glue::bitpack
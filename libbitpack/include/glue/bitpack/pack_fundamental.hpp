@@ -1,28 +1,59 @@
 #pragma once
 
+#include <bit>
 #include <concepts>
 #include <glue/bitpack/packer.hpp>
 #include <type_traits>
 
 namespace glue::bitpack {
-inline constexpr void pack(Packer& packer, u8& value) {
+namespace detail {
+/*
+ * write_bits/read_bits for counts up to 64.
+ */
+template <CWritePacker TPacker>
+inline constexpr void write_wide_bits(TPacker& packer, u64 value, u32 bits) {
+  if (bits > 32) {
+    packer.write_bits(static_cast<u32>(value >> 32), bits - 32);
+    packer.write_bits(static_cast<u32>(value), 32);
+  } else {
+    packer.write_bits(static_cast<u32>(value), bits);
+  }
+}
+
+template <CReadPacker TPacker>
+inline constexpr u64 read_wide_bits(TPacker& packer, u32 bits) {
+  if (bits > 32) {
+    const u64 high = packer.read_bits(bits - 32);
+    return (high << 32) | packer.read_bits(32);
+  }
+  return packer.read_bits(bits);
+}
+}  // namespace detail
+
+template <CWritePacker TPacker>
+inline constexpr void pack(TPacker& packer, u8& value) {
   packer.write_bits(value, 8);
 }
-inline constexpr void pack(Unpacker& packer, u8& value) {
+template <CReadPacker TPacker>
+inline constexpr void pack(TPacker& packer, u8& value) {
   value = packer.read_bits(8);
 }
 
-inline constexpr void pack(Packer& packer, u16& value) {
+template <CWritePacker TPacker>
+inline constexpr void pack(TPacker& packer, u16& value) {
   packer.write_bits(value, 16);
 }
-inline constexpr void pack(Unpacker& packer, u16& value) {
+template <CReadPacker TPacker>
+inline constexpr void pack(TPacker& packer, u16& value) {
   value = packer.read_bits(16);
 }
 
-inline constexpr void pack(Packer& packer, u32& value) {
+template <CWritePacker TPacker>
+inline constexpr void pack(TPacker& packer, u32& value) {
   packer.write_bits(value, 32);
 }
-inline constexpr void pack(Unpacker& packer, u32& value) {
+template <CReadPacker TPacker>
+inline constexpr void pack(TPacker& packer, u32& value) {
   value = packer.read_bits(32);
 }
 
@@ -45,33 +76,26 @@ inline constexpr void pack(TPacker& packer, T& val) {
 
 template <CPacker TPacker>
 inline constexpr void pack(TPacker& packer, f32& val) {
-  // UB but how it's done in game industry afaik.
-  union {
-    f32 float_val;
-    u32 integral_val;
-  };
-  float_val = val;
+  // bit_cast rather than a union so this also works in constant expressions
+  u32 integral_val = std::bit_cast<u32>(val);
   pack(packer, integral_val);
-  val = float_val;
+  val = std::bit_cast<f32>(integral_val);
 }
 
 template <CPacker TPacker>
 inline constexpr void pack(TPacker& packer, f64& val) {
-  // UB but how it's done in game industry afaik.
-  union {
-    f64 float_val;
-    u64 integral_val;
-  };
-  float_val = val;
+  u64 integral_val = std::bit_cast<u64>(val);
   pack(packer, integral_val);
-  val = float_val;
+  val = std::bit_cast<f64>(integral_val);
 }
 
-inline bool constexpr pack(Packer& packer, bool val) {
+template <CWritePacker TPacker>
+inline bool constexpr pack(TPacker& packer, bool val) {
   packer.write_bits(val, 1);
   return val;
 }
-inline bool constexpr pack(Unpacker& packer, bool& val) {
+template <CReadPacker TPacker>
+inline bool constexpr pack(TPacker& packer, bool& val) {
   val = packer.read_bits(1);
   return val;
 }
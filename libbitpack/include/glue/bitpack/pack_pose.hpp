@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cmath>
+#include <concepts>
+#include <glue/assert.hpp>
+#include <glue/bitpack/pack_quantize.hpp>
+#include <glue/types.hpp>
+
+namespace glue::bitpack {
+/*
+ * Quantization settings for a vec3 inside a world-space box.
+ *
+ * Each component is quantized to Bits bits within [min, max].
+ * Values outside the box are clamped.
+ */
+template <u32 Bits>
+struct QuantizeVec3 {
+  static_assert(Bits > 0 && Bits <= 32);
+
+  static constexpr u32 kBitsPerComponent = Bits;
+  static constexpr u32 kPackedBits = 3 * Bits;
+
+  vec3 min;
+  vec3 max;
+};
+
+/*
+ * Quantization settings for a unit quaternion, "smallest three" encoding.
+ *
+ * The largest component is dropped and rebuilt from the unit length on
+ * unpack, so only its 2 bit index and the three remaining components are
+ * sent. The remaining components always lie within [-1/sqrt(2), 1/sqrt(2)],
+ * which is the range quantized to Bits bits each.
+ */
+template <u32 Bits>
+struct QuantizeQuat {
+  static_assert(Bits > 0 && Bits <= 32);
+
+  static constexpr u32 kBitsPerComponent = Bits;
+  static constexpr u32 kIndexBits = 2;
+  static constexpr u32 kPackedBits = kIndexBits + 3 * Bits;
+  static constexpr f32 kComponentMax = 0.70710678118f;  // 1 / sqrt(2)
+};
+
+/*
+ * Quantization settings for a Pose.
+ *
+ * Bit budgets are template parameters so the packed size of a pose is
+ * known at compile time, e.g. QuantizePose<16, 9> packs to 77 bits.
+ */
+template <u32 PositionBits, u32 RotationBits>
+struct QuantizePose {
+  using position_t = QuantizeVec3<PositionBits>;
+  using rotation_t = QuantizeQuat<RotationBits>;
+
+  static constexpr u32 kPackedBits =
+      position_t::kPackedBits + rotation_t::kPackedBits;
+
+  vec3 min;
+  vec3 max;
+
+  constexpr position_t position() const noexcept { return {min, max}; }
+  constexpr rotation_t rotation() const noexcept { return {}; }
+};
+
+template <CWritePacker TPacker, u32 Bits>
+inline constexpr void pack(TPacker& packer, vec3& value,
+                           const QuantizeVec3<Bits>& quantize) {
+  // clamp a copy, writing shouldn't move the caller's value into the box
+  for (int i = 0; i < 3; ++i) {
+    f32 component = value[i];
+    pack_quantize_clamp(packer, component, quantize.min[i], quantize.max[i],
+                        Bits);
+  }
+}
+
+template <CReadPacker TPacker, u32 Bits>
+inline constexpr void pack(TPacker& packer, vec3& value,
+                           const QuantizeVec3<Bits>& quantize) {
+  for (int i = 0; i < 3; ++i) {
+    pack_quantize(packer, value[i], quantize.min[i], quantize.max[i], Bits);
+  }
+}
+
+template <CWritePacker TPacker, u32 Bits>
+inline constexpr void pack(TPacker& packer, quat& value,
+                           const QuantizeQuat<Bits>&) {
+  using Q = QuantizeQuat<Bits>;
+
+  u32 largest = 0;
+  for (u32 i = 1; i < 4; ++i) {
+    if (std::abs(value[i]) > std::abs(value[largest])) {
+      largest = i;
+    }
+  }
+
+  // q and -q are the same rotation, flip so the dropped component is
+  // positive and can be rebuilt with a positive sqrt.
+  const f32 sign = value[largest] < 0.0f ? -1.0f : 1.0f;
+
+  packer.write_bits(largest, Q::kIndexBits);
+  for (u32 i = 0; i < 4; ++i) {
+    if (i != largest) {
+      f32 component = sign * value[i];
+      pack_quantize_clamp(packer, component, -Q::kComponentMax,
+                          Q::kComponentMax, Bits);
+    }
+  }
+}
+
+template <CReadPacker TPacker, u32 Bits>
+inline constexpr void pack(TPacker& packer, quat& value,
+                           const QuantizeQuat<Bits>&) {
+  using Q = QuantizeQuat<Bits>;
+
+  const u32 largest = packer.read_bits(Q::kIndexBits);
+
+  f32 sum_squares = 0.0f;
+  for (u32 i = 0; i < 4; ++i) {
+    if (i != largest) {
+      f32 component = 0.0f;
+      pack_quantize(packer, component, -Q::kComponentMax, Q::kComponentMax,
+                    Bits);
+      value[i] = component;
+      sum_squares += component * component;
+    }
+  }
+  value[largest] = std::sqrt(std::max(0.0f, 1.0f - sum_squares));
+  value = glm::normalize(value);
+}
+
+template <CPacker TPacker, u32 PositionBits, u32 RotationBits>
+inline constexpr void pack(
+    TPacker& packer, Pose& pose,
+    const QuantizePose<PositionBits, RotationBits>& quantize) {
+  pack(packer, pose.position, quantize.position());
+  pack(packer, pose.rotation, quantize.rotation());
+}
+}  // namespace glue::bitpack
@@ -7,9 +7,10 @@
 #include <glue/types.hpp>
 
 namespace glue::bitpack {
-template <typename V, std::floating_point L, std::integral B>
+template <CWritePacker TPacker, typename V, std::floating_point L,
+          std::integral B>
   requires std::same_as<std::remove_reference_t<V>, L>
-inline constexpr void pack_quantize(Packer& packer, V&& value, L min, L max,
+inline constexpr void pack_quantize(TPacker& packer, V&& value, L min, L max,
                                     B bits) {
   glue_assert(bits > 0);
   glue_assert(value >= min);
@@ -23,9 +24,10 @@ inline constexpr void pack_quantize(Packer& packer, V&& value, L min, L max,
   packer.write_bits(store, bits);
 }
 
-template <typename V, std::floating_point L, std::integral B>
+template <CReadPacker TPacker, typename V, std::floating_point L,
+          std::integral B>
   requires std::same_as<std::remove_reference_t<V>, L>
-inline constexpr void pack_quantize(Unpacker& unpacker, V&& value, L min, L max,
+inline constexpr void pack_quantize(TPacker& unpacker, V&& value, L min, L max,
                                     B bits) {
   glue_assert(bits > 0);
 
@@ -3,10 +3,11 @@
 #include <concepts>
 #include <glue/assert.hpp>
 #include <glue/bitpack/pack_bits.hpp>
+#include <span>
 
 namespace glue::bitpack {
-template <std::integral V, std::integral B>
-inline constexpr void pack_range(Packer& packer, V& value, B begin, B end) {
+template <CWritePacker TPacker, std::integral V, std::integral B>
+inline constexpr void pack_range(TPacker& packer, V& value, B begin, B end) {
   glue_assert(value >= begin);
   glue_assert(value < end);
 
@@ -14,9 +15,28 @@ inline constexpr void pack_range(Packer& packer, V& value, B begin, B end) {
   pack_bits(packer, value, begin, bits_needed);
 }
 
-template <std::integral V, std::integral B>
-inline constexpr void pack_range(Unpacker& packer, V& value, B begin, B end) {
+template <CReadPacker TPacker, std::integral V, std::integral B>
+inline constexpr void pack_range(TPacker& packer, V& value, B begin, B end) {
   const auto bits_needed = bits_needed_for_range(begin, end);
   pack_bits(packer, value, begin, bits_needed);
 }
+
+template <CWritePacker TPacker, std::integral V, std::integral B>
+inline constexpr void pack_range(TPacker& packer, std::span<V> values,
+                                 B begin, B end) {
+  for (const auto& value : values) {
+    glue_assert(value >= begin);
+    glue_assert(value < end);
+  }
+
+  const auto bits_needed = bits_needed_for_range(begin, end);
+  pack_bits(packer, values, begin, bits_needed);
+}
+
+template <CReadPacker TPacker, std::integral V, std::integral B>
+inline constexpr void pack_range(TPacker& packer, std::span<V> values,
+                                 B begin, B end) {
+  const auto bits_needed = bits_needed_for_range(begin, end);
+  pack_bits(packer, values, begin, bits_needed);
+}
 }  // namespace glue::bitpack
\ No newline at end of file
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <glue/assert.hpp>
+#include <glue/bitpack/math.hpp>
+#include <glue/bitpack/pack_fundamental.hpp>
+#include <glue/types.hpp>
+#include <type_traits>
+
+namespace glue::bitpack {
+/*
+ * Variable length integer codes.
+ *
+ * Small values cost few bits, large values still round trip. Signed values
+ * are zigzag mapped first, so small magnitudes of either sign are cheap.
+ *
+ * pack_varint(packer, value) uses ExpGolomb<0>.
+ * pack_varint(packer, value, Chunked<7>{}) picks another code.
+ */
+
+/*
+ * Exponential-Golomb code of order K.
+ *
+ * Writes n zeros, a 1 and n more bits for (value >> K) + 1, then the low K
+ * bits of value raw. K = 0 is the Elias-gamma code of value + 1:
+ * 0 -> 1 bit, 1..2 -> 3 bits, 3..6 -> 5 bits, ...
+ *
+ * Larger K makes typical values of around 2^K cheaper and tiny values
+ * more expensive.
+ */
+template <u32 K>
+struct ExpGolomb {
+  static_assert(K < 64);
+
+  static constexpr u32 kMaxPrefixBits = 64;
+
+  static constexpr u32 prefix_bits(u64 value) noexcept {
+    const u64 q = value >> K;
+    if (q == ~u64{0}) {
+      return kMaxPrefixBits;
+    }
+    return static_cast<u32>(std::bit_width(q + 1)) - 1;
+  }
+
+  static constexpr u32 bits(u64 value) noexcept {
+    return 2 * prefix_bits(value) + 1 + K;
+  }
+};
+
+/*
+ * Chunked code, LEB128 style but in bits.
+ *
+ * Sends value N bits at a time, least significant chunk first, each chunk
+ * preceded by a continuation bit.
+ */
+template <u32 N>
+struct Chunked {
+  static_assert(N > 0 && N <= 32);
+
+  static constexpr u32 bits(u64 value) noexcept {
+    u32 chunks = 1;
+    while ((value >>= N) != 0) {
+      ++chunks;
+    }
+    return chunks * (N + 1);
+  }
+};
+
+namespace detail {
+template <CWritePacker TPacker, u32 K>
+inline constexpr void write_varint(TPacker& packer, u64 value, ExpGolomb<K>) {
+  const u32 prefix = ExpGolomb<K>::prefix_bits(value);
+  // low prefix bits of q + 1, wrapping gives the right bits for q = 2^64 - 1
+  const u64 q_plus_one = (value >> K) + 1;
+
+  if (2 * prefix + 1 <= 64) {
+    // q + 1 is prefix + 1 bits wide, so this is the zeros, the 1 and the rest
+    write_wide_bits(packer, q_plus_one, 2 * prefix + 1);
+  } else {
+    write_wide_bits(packer, 0, prefix);
+    packer.write_bits(1, 1);
+    write_wide_bits(packer, q_plus_one, prefix);
+  }
+  if constexpr (K > 0) {
+    write_wide_bits(packer, value, K);
+  }
+}
+
+template <CReadPacker TPacker, u32 K>
+inline constexpr u64 read_varint(TPacker& packer, ExpGolomb<K>) {
+  // bounded, so zeros from a corrupt or overrun buffer can't spin forever
+  constexpr u32 kMaxPrefixBits = ExpGolomb<K>::kMaxPrefixBits;
+  u32 prefix = 0;
+  while (packer.read_bits(1) == 0 && prefix <= kMaxPrefixBits) {
+    ++prefix;
+  }
+  prefix = std::min(prefix, kMaxPrefixBits);
+
+  u64 q = 0;
+  if (prefix > 0) {
+    const u64 leading_one = prefix < 64 ? (u64{1} << prefix) : 0;
+    q = (leading_one | read_wide_bits(packer, prefix)) - 1;
+  }
+  if constexpr (K > 0) {
+    return (q << K) | read_wide_bits(packer, K);
+  }
+  return q;
+}
+
+template <CWritePacker TPacker, u32 N>
+inline constexpr void write_varint(TPacker& packer, u64 value, Chunked<N>) {
+  constexpr u64 kChunkMask = (u64{1} << N) - 1;
+  for (;;) {
+    const u64 rest = value >> N;
+    packer.write_bits(rest != 0, 1);
+    packer.write_bits(static_cast<u32>(value & kChunkMask), N);
+    if (rest == 0) {
+      return;
+    }
+    value = rest;
+  }
+}
+
+template <CReadPacker TPacker, u32 N>
+inline constexpr u64 read_varint(TPacker& packer, Chunked<N>) {
+  u64 value = 0;
+  for (u32 shift = 0; shift < 64; shift += N) {
+    const bool more = packer.read_bits(1);
+    value |= u64{packer.read_bits(N)} << shift;
+    if (!more) {
+      break;
+    }
+  }
+  return value;
+}
+
+template <std::integral V>
+inline constexpr u64 varint_map(V value) noexcept {
+  if constexpr (std::is_signed_v<V>) {
+    return zigzag_encode(value);
+  } else {
+    return value;
+  }
+}
+
+template <std::integral V>
+inline constexpr V varint_unmap(u64 value) noexcept {
+  using U = std::make_unsigned_t<V>;
+  if constexpr (std::is_signed_v<V>) {
+    return zigzag_decode(static_cast<U>(value));
+  } else {
+    return static_cast<V>(value);
+  }
+}
+}  // namespace detail
+
+/*
+ * Number of bits pack_varint writes for value.
+ */
+template <std::integral V, typename Code = ExpGolomb<0>>
+inline constexpr u32 varint_bits(V value, Code = {}) noexcept {
+  return Code::bits(detail::varint_map(value));
+}
+
+template <CWritePacker TPacker, std::integral V, typename Code = ExpGolomb<0>>
+inline constexpr void pack_varint(TPacker& packer, const V& value,
+                                  Code code = {}) {
+  detail::write_varint(packer, detail::varint_map(value), code);
+}
+
+template <CReadPacker TPacker, std::integral V, typename Code = ExpGolomb<0>>
+inline constexpr void pack_varint(TPacker& packer, V& value, Code code = {}) {
+  const u64 mapped = detail::read_varint(packer, code);
+  glue_assert(mapped <= static_cast<std::make_unsigned_t<V>>(~0ull));
+  value = detail::varint_unmap<V>(mapped);
+}
+}  // namespace glue::bitpack
@@ -57,7 +57,8 @@ struct Packer final : public detail::BasePacker {
     const size_t space = kValueSizeBits - (current_bit() & kAlignMask);
     if (space >= count) {
       const auto shift = space - count;
-      const auto zero_mask = ~((1 << count) - 1) << shift;
+      const auto zero_mask = static_cast<value_t>(~((1ull << count) - 1))
+                             << shift;
       data_[current()] &= zero_mask;       // zero-out the bits we'll write to
       data_[current()] |= value << shift;  // write value in there
       bit_position_ += count;
@@ -67,9 +68,60 @@ struct Packer final : public detail::BasePacker {
       write_bits(value, count - space);
     }
   }
+
+  /*
+   * Write n values of count bits each, value_at(i) supplying the i-th value.
+   *
+   * Same result as n calls to write_bits(), but shifts values into a
+   * register and stores whole words instead of masking memory per value.
+   */
+  template <std::convertible_to<size_t> C, std::invocable<size_t> Fn>
+  constexpr void write_bits_n(size_t n, C count, Fn&& value_at) {
+    const size_t bits = count;
+    glue_assert(bits <= kValueSizeBits);
+    glue_assert(current_bit() + n * bits <= capacity_bits());
+    if (n == 0 || bits == 0) {
+      return;
+    }
+
+    // seed the scratch register with the bits already in the current word
+    constexpr auto kAlignMask = kValueSizeBits - 1;
+    size_t word = current();
+    size_t scratch_bits = current_bit() & kAlignMask;
+    u64 scratch = 0;
+    if (scratch_bits > 0) {
+      scratch = data_[word] >> (kValueSizeBits - scratch_bits);
+    }
+
+    const u64 value_mask = (1ull << bits) - 1;
+    for (size_t i = 0; i < n; ++i) {
+      scratch = (scratch << bits) | (value_at(i) & value_mask);
+      scratch_bits += bits;
+      if (scratch_bits >= kValueSizeBits) {
+        scratch_bits -= kValueSizeBits;
+        data_[word++] = static_cast<value_t>(scratch >> scratch_bits);
+      }
+    }
+
+    // merge the trailing partial word, keeping the bits after it intact
+    if (scratch_bits > 0) {
+      const auto shift = kValueSizeBits - scratch_bits;
+      const auto keep_mask = static_cast<value_t>((1ull << shift) - 1);
+      data_[word] = (data_[word] & keep_mask) |
+                    static_cast<value_t>(scratch << shift);
+    }
+    bit_position_ += n * bits;
+  }
 };
 
 struct Unpacker final : public detail::BasePacker {
+  /*
+   * A saved read position, see checkpoint() and restore().
+   */
+  struct Checkpoint {
+    size_t bit_position;
+  };
+
   constexpr Unpacker() = default;
   explicit constexpr Unpacker(std::span<value_t> data) noexcept
       : detail::BasePacker{data} {}
@@ -78,27 +130,357 @@ struct Unpacker final : public detail::BasePacker {
    * Read count bits and advance position.
    */
   constexpr value_t read_bits(size_t count) {
+    const value_t value = peek_bits(count);
+    bit_position_ += count;
+    return value;
+  }
+
+  /*
+   * Read count bits without advancing position.
+   */
+  constexpr value_t peek_bits(size_t count) const {
     glue_assert(count <= kValueSizeBits);
     glue_assert(current_bit() + count <= capacity_bits());
 
     const value_t value_mask = static_cast<value_t>((1ull << count) - 1);
 
     constexpr auto kAlignMask = kValueSizeBits - 1;
-    const size_t space = kValueSizeBits - (current_bit() & kAlignMask);
+    const size_t offset = current_bit() & kAlignMask;
+    const size_t space = kValueSizeBits - offset;
     if (space >= count) {
-      const auto shift = space - count;
-      const value_t value = (data_[current()] >> shift) & value_mask;
-      bit_position_ += count;
-      return value;
-    } else {
-      const value_t high_mask = (1 << space) - 1;
-      const value_t high_value = read_bits(space);
-      const value_t low_value = read_bits(count - space);
-      return (high_value << (count - space)) | low_value;
+      return (data_[current()] >> (space - count)) & value_mask;
+    }
+
+    const u64 window =
+        (u64{data_[current()]} << kValueSizeBits) | data_[next()];
+    const size_t shift = 2 * kValueSizeBits - offset - count;
+    return static_cast<value_t>(window >> shift) & value_mask;
+  }
+
+  /*
+   * Advance position by count bits, any count.
+   */
+  constexpr void skip_bits(size_t count) {
+    glue_assert(current_bit() + count <= capacity_bits());
+    bit_position_ += count;
+  }
+
+  /*
+   * Move to an absolute bit position, forwards or backwards.
+   */
+  constexpr void seek(size_t bit) {
+    glue_assert(bit <= capacity_bits());
+    bit_position_ = bit;
+  }
+
+  constexpr Checkpoint checkpoint() const noexcept { return {bit_position_}; }
+  constexpr void restore(Checkpoint checkpoint) {
+    seek(checkpoint.bit_position);
+  }
+
+  /*
+   * Unpacker over the rest of the buffer, starting at the current position.
+   *
+   * Shares the same memory, nothing is copied, so a dispatcher can read a
+   * message header and hand the payload off to another thread.
+   */
+  constexpr Unpacker remainder() const {
+    constexpr auto kAlignMask = kValueSizeBits - 1;
+    Unpacker rest{data_.subspan(current())};
+    rest.bit_position_ = current_bit() & kAlignMask;
+    return rest;
+  }
+
+  /*
+   * Read n values of count bits each, passing each to store_at(i, value).
+   *
+   * Same result as n calls to read_bits(), but loads each word only once.
+   */
+  template <std::convertible_to<size_t> C,
+            std::invocable<size_t, value_t> Fn>
+  constexpr void read_bits_n(size_t n, C count, Fn&& store_at) {
+    const size_t bits = count;
+    glue_assert(bits <= kValueSizeBits);
+    glue_assert(current_bit() + n * bits <= capacity_bits());
+
+    constexpr auto kAlignMask = kValueSizeBits - 1;
+    size_t word = current();
+    size_t scratch_bits = 0;
+    u64 scratch = 0;
+    if (bits > 0 && (current_bit() & kAlignMask) != 0) {
+      scratch = data_[word++];
+      scratch_bits = kValueSizeBits - (current_bit() & kAlignMask);
+    }
+
+    const u64 value_mask = (1ull << bits) - 1;
+    for (size_t i = 0; i < n; ++i) {
+      if (scratch_bits < bits) {
+        scratch = (scratch << kValueSizeBits) | data_[word++];
+        scratch_bits += kValueSizeBits;
+      }
+      scratch_bits -= bits;
+      store_at(i, static_cast<value_t>((scratch >> scratch_bits) & value_mask));
+    }
+    bit_position_ += n * bits;
+  }
+};
+
+/*
+ * Buffered variant of Packer.
+ *
+ * Accumulates bits in a 64-bit scratch register and only stores whole words
+ * once 32 bits are ready, so no word is ever read back or masked in memory.
+ * Produces exactly the same bits as Packer.
+ *
+ * The trailing partial word stays in the scratch register until flush() is
+ * called. Call flush() before handing the buffer off.
+ */
+struct StreamPacker final : public detail::BasePacker {
+  constexpr StreamPacker() = default;
+  explicit constexpr StreamPacker(std::span<value_t> data) noexcept
+      : detail::BasePacker{data} {}
+
+  /*
+   * Write count bits and advance position.
+   */
+  constexpr void write_bits(value_t value, size_t count) {
+    glue_assert(count <= kValueSizeBits);
+    glue_assert(current_bit() + count <= capacity_bits());
+
+    const u64 value_mask = (1ull << count) - 1;
+    scratch_ = (scratch_ << count) | (value & value_mask);
+    scratch_bits_ += count;
+    bit_position_ += count;
+
+    if (scratch_bits_ >= kValueSizeBits) {
+      scratch_bits_ -= kValueSizeBits;
+      data_[word_++] = static_cast<value_t>(scratch_ >> scratch_bits_);
+    }
+  }
+
+  /*
+   * Write n values of count bits each, value_at(i) supplying the i-th value.
+   *
+   * Keeps the scratch register in locals for the duration of the loop.
+   */
+  template <std::convertible_to<size_t> C, std::invocable<size_t> Fn>
+  constexpr void write_bits_n(size_t n, C count, Fn&& value_at) {
+    const size_t bits = count;
+    glue_assert(bits <= kValueSizeBits);
+    glue_assert(current_bit() + n * bits <= capacity_bits());
+
+    u64 scratch = scratch_;
+    size_t scratch_bits = scratch_bits_;
+    size_t word = word_;
+
+    const u64 value_mask = (1ull << bits) - 1;
+    for (size_t i = 0; i < n; ++i) {
+      scratch = (scratch << bits) | (value_at(i) & value_mask);
+      scratch_bits += bits;
+      if (scratch_bits >= kValueSizeBits) {
+        scratch_bits -= kValueSizeBits;
+        data_[word++] = static_cast<value_t>(scratch >> scratch_bits);
+      }
+    }
+
+    scratch_ = scratch;
+    scratch_bits_ = scratch_bits;
+    word_ = word;
+    bit_position_ += n * bits;
+  }
+
+  /*
+   * Store the pending partial word, padded with zero bits.
+   *
+   * Does not advance position, so writing may continue after a flush.
+   */
+  constexpr void flush() {
+    if (scratch_bits_ > 0) {
+      const auto shift = kValueSizeBits - scratch_bits_;
+      data_[word_] = static_cast<value_t>(scratch_ << shift);
+    }
+  }
+
+ private:
+  u64 scratch_{0};
+  size_t scratch_bits_{0};
+  size_t word_{0};
+};
+
+/*
+ * Buffered variant of Unpacker.
+ *
+ * Loads whole words into a 64-bit scratch register and serves reads from it.
+ * Reads exactly the same bits as Unpacker.
+ */
+struct StreamUnpacker final : public detail::BasePacker {
+  constexpr StreamUnpacker() = default;
+  explicit constexpr StreamUnpacker(std::span<value_t> data) noexcept
+      : detail::BasePacker{data} {}
+
+  /*
+   * Read count bits and advance position.
+   */
+  constexpr value_t read_bits(size_t count) {
+    glue_assert(count <= kValueSizeBits);
+    glue_assert(current_bit() + count <= capacity_bits());
+
+    if (scratch_bits_ < count) {
+      scratch_ = (scratch_ << kValueSizeBits) | data_[word_++];
+      scratch_bits_ += kValueSizeBits;
     }
+
+    const u64 value_mask = (1ull << count) - 1;
+    scratch_bits_ -= count;
+    bit_position_ += count;
+    return static_cast<value_t>((scratch_ >> scratch_bits_) & value_mask);
   }
+
+  /*
+   * Read n values of count bits each, passing each to store_at(i, value).
+   *
+   * Keeps the scratch register in locals for the duration of the loop.
+   */
+  template <std::convertible_to<size_t> C,
+            std::invocable<size_t, value_t> Fn>
+  constexpr void read_bits_n(size_t n, C count, Fn&& store_at) {
+    const size_t bits = count;
+    glue_assert(bits <= kValueSizeBits);
+    glue_assert(current_bit() + n * bits <= capacity_bits());
+
+    u64 scratch = scratch_;
+    size_t scratch_bits = scratch_bits_;
+    size_t word = word_;
+
+    const u64 value_mask = (1ull << bits) - 1;
+    for (size_t i = 0; i < n; ++i) {
+      if (scratch_bits < bits) {
+        scratch = (scratch << kValueSizeBits) | data_[word++];
+        scratch_bits += kValueSizeBits;
+      }
+      scratch_bits -= bits;
+      store_at(i, static_cast<value_t>((scratch >> scratch_bits) & value_mask));
+    }
+
+    scratch_ = scratch;
+    scratch_bits_ = scratch_bits;
+    word_ = word;
+    bit_position_ += n * bits;
+  }
+
+ private:
+  u64 scratch_{0};
+  size_t scratch_bits_{0};
+  size_t word_{0};
 };
 
+/*
+ * Unpacker for untrusted data.
+ *
+ * Bits past capacity read as zeros instead of touching memory outside the
+ * buffer, in release builds too, and overflowed() tells whether that
+ * happened. Test it once after unpacking a whole message rather than after
+ * every read.
+ *
+ * Buffered like StreamUnpacker, so the capacity check is only paid when
+ * refilling the scratch register, once per 32 bits read.
+ */
+struct CheckedUnpacker final : public detail::BasePacker {
+  constexpr CheckedUnpacker() = default;
+  explicit constexpr CheckedUnpacker(std::span<value_t> data) noexcept
+      : detail::BasePacker{data} {}
+
+  /*
+   * Read count bits and advance position.
+   */
+  constexpr value_t read_bits(size_t count) {
+    glue_assert(count <= kValueSizeBits);
+
+    if (scratch_bits_ < count) {
+      scratch_ = (scratch_ << kValueSizeBits) | next_word();
+      scratch_bits_ += kValueSizeBits;
+    }
+
+    const u64 value_mask = (1ull << count) - 1;
+    scratch_bits_ -= count;
+    bit_position_ += count;
+    return static_cast<value_t>((scratch_ >> scratch_bits_) & value_mask);
+  }
+
+  /*
+   * True once any read went past capacity. Stays set, the position only
+   * moves forward.
+   */
+  constexpr bool overflowed() const noexcept {
+    return current_bit() > capacity_bits();
+  }
+
+ private:
+  constexpr value_t next_word() noexcept {
+    const value_t word = word_ < capacity() ? data_[word_] : 0;
+    ++word_;
+    return word;
+  }
+
+ private:
+  u64 scratch_{0};
+  size_t scratch_bits_{0};
+  size_t word_{0};
+};
+
+/*
+ * Packer that only counts bits.
+ *
+ * Takes the same pack() path as Packer, so the final current_bit() is the
+ * exact encoded size, without needing a buffer. Usable in constant
+ * expressions, e.g. to size a Packet for a fixed-size message at compile
+ * time.
+ */
+struct Measurer final : public detail::BasePacker {
+  constexpr Measurer() = default;
+  // not = default, GCC can't use a defaulted virtual destructor in constant
+  // expressions within the same class definition
+  constexpr ~Measurer() override {}
+
+  constexpr void write_bits(value_t, size_t count) {
+    glue_assert(count <= kValueSizeBits);
+    bit_position_ += count;
+  }
+
+  template <std::convertible_to<size_t> C, std::invocable<size_t> Fn>
+  constexpr void write_bits_n(size_t n, C count, Fn&&) {
+    const size_t bits = count;
+    glue_assert(bits <= kValueSizeBits);
+    bit_position_ += n * bits;
+  }
+};
+
+/*
+ * Bits written by pack_fn(measurer).
+ */
+template <std::invocable<Measurer&> Fn>
+inline constexpr std::size_t measure_bits(Fn&& pack_fn) {
+  Measurer measurer;
+  pack_fn(measurer);
+  return measurer.current_bit();
+}
+
 template <class T>
 concept CPacker = std::derived_from<T, detail::BasePacker>;
+
+/*
+ * Packers that serialize (write_bits) or deserialize (read_bits).
+ *
+ * Low-level pack() overloads are written against these so every packer
+ * backend shares the same overload set.
+ */
+template <class T>
+concept CWritePacker = CPacker<T> && requires(T t, u32 value, std::size_t n) {
+  t.write_bits(value, n);
+};
+
+template <class T>
+concept CReadPacker = CPacker<T> && requires(T t, std::size_t n) {
+  { t.read_bits(n) } -> std::convertible_to<u32>;
+};
 }  // namespace glue::bitpack
\ No newline at end of file
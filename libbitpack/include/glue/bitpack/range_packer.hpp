@@ -0,0 +1,236 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <glue/assert.hpp>
+#include <glue/bitpack/packer.hpp>
+#include <glue/types.hpp>
+#include <span>
+
+namespace glue::bitpack::detail {
+/*
+ * Adaptive bit probabilities shared by RangePacker and RangeUnpacker.
+ *
+ * Each bit gets a context from the width of the write_bits() call it is
+ * part of and its position within it. Fields of the same width share
+ * contexts, so a 1 bit "active" flag, the high bits of small deltas etc.
+ * each learn their own skew.
+ *
+ * Probabilities are 11 bit fixed point chances of a 0 and move 1/32 of the
+ * way towards every coded bit, as in LZMA.
+ */
+class RangeCoderModel {
+ public:
+  static constexpr u32 kProbabilityBits = 11;
+  static constexpr u32 kProbabilityOne = 1 << kProbabilityBits;
+  static constexpr u32 kAdaptShift = 5;
+  static constexpr u32 kTopValue = 1 << 24;
+
+  constexpr RangeCoderModel() noexcept {
+    probabilities_.fill(kProbabilityOne / 2);
+  }
+
+  constexpr u16& probability(std::size_t count, std::size_t bit) noexcept {
+    return probabilities_[(count - 1) * BasePacker::kValueSizeBits + bit];
+  }
+
+  static constexpr void adapt(u16& probability, u32 bit) noexcept {
+    if (bit) {
+      probability -= probability >> kAdaptShift;
+    } else {
+      probability += (kProbabilityOne - probability) >> kAdaptShift;
+    }
+  }
+
+ private:
+  std::array<u16, BasePacker::kValueSizeBits * BasePacker::kValueSizeBits>
+      probabilities_{};
+};
+}  // namespace glue::bitpack::detail
+
+namespace glue::bitpack {
+/*
+ * Entropy coding packer, adaptive binary range coder.
+ *
+ * Drop-in for Packer in any pack() function: every bit written is coded
+ * against an adaptive model, so skewed data (resting objects, rarely set
+ * flags, small deltas) packs well below its bit width. Decode with
+ * RangeUnpacker using the same sequence of pack() calls.
+ *
+ * current_bit() counts bits passed to write_bits(), i.e. the same position
+ * a Packer would be at. size_bytes() is the compressed size, final once
+ * flush() has been called. Call flush() before handing the buffer off.
+ *
+ * The output isn't bounded by what Measurer reports: incompressible data
+ * comes out a little larger than its bits plus 5 flush bytes. Bytes past
+ * capacity are dropped, in release builds too, and overflowed() tells
+ * whether that happened. Check it after flush().
+ */
+struct RangePacker final : public detail::BasePacker {
+  constexpr RangePacker() = default;
+  explicit constexpr RangePacker(std::span<value_t> data) noexcept
+      : detail::BasePacker{data} {}
+
+  /*
+   * Write count bits and advance position.
+   */
+  constexpr void write_bits(value_t value, size_t count) {
+    glue_assert(count <= kValueSizeBits);
+
+    for (size_t i = 0; i < count; ++i) {
+      const u32 bit = (value >> (count - 1 - i)) & 1;
+      encode(model_.probability(count, i), bit);
+    }
+    bit_position_ += count;
+  }
+
+  /*
+   * Write out the bytes still pending in the coder.
+   */
+  constexpr void flush() {
+    for (int i = 0; i < 5; ++i) {
+      shift_low();
+    }
+  }
+
+  /*
+   * Bytes the coded data needs, more than the buffer holds if overflowed().
+   */
+  constexpr size_t size_bytes() const noexcept { return bytes_; }
+
+  /*
+   * True once a byte didn't fit in the buffer, the data is unusable. Stays
+   * set, the byte count only moves forward.
+   */
+  constexpr bool overflowed() const noexcept {
+    return bytes_ > capacity() * sizeof(value_t);
+  }
+
+ private:
+  using Model = detail::RangeCoderModel;
+
+  constexpr void encode(u16& probability, u32 bit) {
+    const u32 bound = (range_ >> Model::kProbabilityBits) * probability;
+    if (bit) {
+      low_ += bound;
+      range_ -= bound;
+    } else {
+      range_ = bound;
+    }
+    Model::adapt(probability, bit);
+
+    while (range_ < Model::kTopValue) {
+      range_ <<= 8;
+      shift_low();
+    }
+  }
+
+  /*
+   * Emits the top byte of low_, holding back 0xff bytes until it is known
+   * whether a carry will ripple into them.
+   */
+  constexpr void shift_low() {
+    if (static_cast<u32>(low_) < 0xff000000u || (low_ >> 32) != 0) {
+      const u8 carry = static_cast<u8>(low_ >> 32);
+      u8 byte = cache_;
+      do {
+        write_byte(static_cast<u8>(byte + carry));
+        byte = 0xff;
+      } while (--cache_size_ != 0);
+      cache_ = static_cast<u8>(low_ >> 24);
+    }
+    ++cache_size_;
+    low_ = (low_ & 0x00ffffffu) << 8;
+  }
+
+  constexpr void write_byte(u8 byte) {
+    if (bytes_ >= capacity() * sizeof(value_t)) {
+      ++bytes_;
+      return;
+    }
+    const size_t word = bytes_ / sizeof(value_t);
+    const size_t shift = 24 - 8 * (bytes_ % sizeof(value_t));
+    if (shift == 24) {
+      data_[word] = 0;
+    }
+    data_[word] |= value_t{byte} << shift;
+    ++bytes_;
+  }
+
+ private:
+  Model model_{};
+  u64 low_{0};
+  u32 range_{0xffffffffu};
+  u8 cache_{0};
+  size_t cache_size_{1};
+  size_t bytes_{0};
+};
+
+/*
+ * Decodes RangePacker output.
+ *
+ * Reading past the end of the buffer yields zero bytes, so a truncated
+ * buffer decodes to garbage rather than reading out of bounds.
+ */
+struct RangeUnpacker final : public detail::BasePacker {
+  constexpr RangeUnpacker() = default;
+  explicit constexpr RangeUnpacker(std::span<value_t> data) noexcept
+      : detail::BasePacker{data} {
+    for (int i = 0; i < 5; ++i) {
+      code_ = (code_ << 8) | read_byte();
+    }
+  }
+
+  /*
+   * Read count bits and advance position.
+   */
+  constexpr value_t read_bits(size_t count) {
+    glue_assert(count <= kValueSizeBits);
+
+    value_t value = 0;
+    for (size_t i = 0; i < count; ++i) {
+      value = (value << 1) | decode(model_.probability(count, i));
+    }
+    bit_position_ += count;
+    return value;
+  }
+
+ private:
+  using Model = detail::RangeCoderModel;
+
+  constexpr u32 decode(u16& probability) {
+    const u32 bound = (range_ >> Model::kProbabilityBits) * probability;
+    u32 bit = 0;
+    if (code_ < bound) {
+      range_ = bound;
+    } else {
+      code_ -= bound;
+      range_ -= bound;
+      bit = 1;
+    }
+    Model::adapt(probability, bit);
+
+    while (range_ < Model::kTopValue) {
+      range_ <<= 8;
+      code_ = (code_ << 8) | read_byte();
+    }
+    return bit;
+  }
+
+  constexpr u8 read_byte() {
+    if (bytes_ >= capacity() * sizeof(value_t)) {
+      return 0;
+    }
+    const size_t word = bytes_ / sizeof(value_t);
+    const size_t shift = 24 - 8 * (bytes_ % sizeof(value_t));
+    ++bytes_;
+    return static_cast<u8>(data_[word] >> shift);
+  }
+
+ private:
+  Model model_{};
+  u32 code_{0};
+  u32 range_{0xffffffffu};
+  size_t bytes_{0};
+};
+}  // namespace glue::bitpack
@@ -0,0 +1,126 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <glue/bitpack/bitpack.hpp>
+#include <random>
+#include <vector>
+
+using namespace glue;
+using namespace glue::bitpack;
+using namespace ::testing;
+
+TEST(CheckedUnpackerTests, ReadBitsCorrectly) {
+  std::array<u32, 2> data{{0b0101'0110'1111'0101'1111'0101'1100'0000,
+                           0b0000'0000'0000'0000'0000'0000'0011'0000}};
+  CheckedUnpacker unpacker{data};
+
+  EXPECT_EQ(unpacker.read_bits(16), 0b0101'0110'1111'0101);
+  EXPECT_EQ(unpacker.read_bits(10), 0b1111'0101'11);
+  EXPECT_EQ(unpacker.read_bits(32), 0);
+  EXPECT_EQ(unpacker.current_bit(), 58);
+  EXPECT_EQ(unpacker.read_bits(0), 0);
+  EXPECT_EQ(unpacker.read_bits(2), 0b11);
+  EXPECT_EQ(unpacker.read_bits(4), 0);
+  EXPECT_EQ(unpacker.current_bit(), 64);
+  EXPECT_FALSE(unpacker.overflowed());
+}
+
+TEST(CheckedUnpackerTests, GivenRandomWrites_ReadsBackSameValues) {
+  std::mt19937 rng{555};
+  std::uniform_int_distribution<u32> bits_dist{0, 32};
+  std::uniform_int_distribution<u32> value_dist;
+
+  std::vector<std::pair<u32, u32>> writes;
+  std::vector<u32> data(1000);
+  Packer packer{data};
+  for (int i = 0; i < 1000; ++i) {
+    const u32 bits = bits_dist(rng);
+    const u32 value = value_dist(rng) & static_cast<u32>((1ull << bits) - 1);
+    packer.write_bits(value, bits);
+    writes.emplace_back(value, bits);
+  }
+
+  CheckedUnpacker unpacker{data};
+  for (const auto& [value, bits] : writes) {
+    ASSERT_EQ(unpacker.read_bits(bits), value);
+  }
+  EXPECT_FALSE(unpacker.overflowed());
+}
+
+TEST(CheckedUnpackerTests, ReadExactlyToCapacityDoesNotOverflow) {
+  std::array<u32, 1> data{{0xffffffff}};
+  CheckedUnpacker unpacker{data};
+  EXPECT_EQ(unpacker.read_bits(20), 0xfffff);
+  EXPECT_EQ(unpacker.read_bits(12), 0xfff);
+  EXPECT_FALSE(unpacker.overflowed());
+}
+
+TEST(CheckedUnpackerTests, BitsPastCapacityReadAsZerosAndSetFlag) {
+  std::array<u32, 1> data{{0xffffffff}};
+  CheckedUnpacker unpacker{data};
+  EXPECT_EQ(unpacker.read_bits(20), 0xfffff);
+  EXPECT_EQ(unpacker.read_bits(20), 0b1111'1111'1111'0000'0000);
+  EXPECT_TRUE(unpacker.overflowed());
+  EXPECT_EQ(unpacker.read_bits(20), 0);
+}
+
+TEST(CheckedUnpackerTests, OverflowFlagIsSticky) {
+  std::array<u32, 2> data{{0xffffffff, 0xffffffff}};
+  CheckedUnpacker unpacker{data};
+  unpacker.read_bits(32);
+  unpacker.read_bits(32);
+  EXPECT_FALSE(unpacker.overflowed());
+
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(unpacker.read_bits(32), 0);
+  }
+  EXPECT_EQ(unpacker.read_bits(0), 0);
+  EXPECT_TRUE(unpacker.overflowed());
+}
+
+TEST(CheckedUnpackerTests, EmptyBufferOverflowsOnFirstRead) {
+  CheckedUnpacker unpacker;
+  EXPECT_EQ(unpacker.read_bits(0), 0);
+  EXPECT_FALSE(unpacker.overflowed());
+  EXPECT_EQ(unpacker.read_bits(1), 0);
+  EXPECT_TRUE(unpacker.overflowed());
+}
+
+TEST(CheckedUnpackerTests, TruncatedMessageDetectedOnce) {
+  std::array<u32, 4> data{};
+  Packer packer{data};
+  u64 a = 0x0123456789abcdefull;
+  f32 b = 3.5f;
+  u32 c = 42;
+  pack(packer, a);
+  pack(packer, b);
+  pack(packer, c);
+
+  // only the first two words made it
+  CheckedUnpacker unpacker{std::span{data}.first(2)};
+  u64 a2{};
+  f32 b2{};
+  u32 c2{};
+  pack(unpacker, a2);
+  pack(unpacker, b2);
+  pack(unpacker, c2);
+
+  EXPECT_EQ(a2, a);
+  EXPECT_EQ(b2, 0.0f);
+  EXPECT_EQ(c2, 0);
+  EXPECT_TRUE(unpacker.overflowed());
+}
+
+TEST(CheckedUnpackerTests, VarintOfZerosTerminates) {
+  std::array<u32, 1> data{};
+  CheckedUnpacker unpacker{data};
+  u64 value = 1;
+  pack_varint(unpacker, value);
+  EXPECT_TRUE(unpacker.overflowed());
+
+  CheckedUnpacker chunked_unpacker{data};
+  pack_varint(chunked_unpacker, value, Chunked<4>{});
+  EXPECT_EQ(value, 0);
+  EXPECT_FALSE(chunked_unpacker.overflowed());
+}
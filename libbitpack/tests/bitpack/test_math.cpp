@@ -36,4 +36,29 @@ TEST(MathTests, CorrectNumberOfBitsForRange) {
 TEST(MathTests, BackwardsRangeWorks) {
   EXPECT_EQ(bits_needed_for_range(2512ll, -12512512572ll), 34);
   EXPECT_EQ(bits_needed_for_range(12512512572, -53125123512), 36);
-}
\ No newline at end of file
+}
+
+TEST(MathTests, ZigzagEncodeInterleavesSigns) {
+  EXPECT_EQ(zigzag_encode(i32{0}), 0u);
+  EXPECT_EQ(zigzag_encode(i32{-1}), 1u);
+  EXPECT_EQ(zigzag_encode(i32{1}), 2u);
+  EXPECT_EQ(zigzag_encode(i32{-2}), 3u);
+  EXPECT_EQ(zigzag_encode(i32{2147483647}), 4294967294u);
+  EXPECT_EQ(zigzag_encode(i32{-2147483647 - 1}), 4294967295u);
+  EXPECT_EQ(zigzag_encode(i8{-128}), u8{255});
+  EXPECT_EQ(zigzag_encode(i8{127}), u8{254});
+}
+
+TEST(MathTests, ZigzagDecodeInvertsEncode) {
+  for (i32 value : {0, 1, -1, 2, -2, 1000, -1000, 2147483647,
+                    -2147483647 - 1}) {
+    EXPECT_EQ(zigzag_decode(zigzag_encode(value)), value);
+  }
+  for (i64 value : {0ll, -1ll, 9223372036854775807ll,
+                    -9223372036854775807ll - 1}) {
+    EXPECT_EQ(zigzag_decode(zigzag_encode(value)), value);
+  }
+  for (int value = -128; value <= 127; ++value) {
+    EXPECT_EQ(zigzag_decode(zigzag_encode(static_cast<i8>(value))), value);
+  }
+}
@@ -0,0 +1,109 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <glue/bitpack/bitpack.hpp>
+#include <glue/bitpack/pack_delta.hpp>
+#include <glue/bitpack/pack_pose.hpp>
+#include <random>
+#include <span>
+#include <vector>
+
+using namespace glue;
+using namespace glue::bitpack;
+using namespace ::testing;
+
+namespace {
+/*
+ * Packs with a real Packer and a Measurer, checks both end at the same bit.
+ */
+template <typename Fn>
+void expect_measured_matches_packed(Fn&& pack_fn) {
+  std::vector<u32> data(1024);
+  Packer packer{data};
+  pack_fn(packer);
+  EXPECT_EQ(measure_bits(pack_fn), packer.current_bit());
+}
+}  // namespace
+
+TEST(MeasurerTests, SatisfiesWritePacker) {
+  static_assert(CPacker<Measurer>);
+  static_assert(CWritePacker<Measurer>);
+  static_assert(!CReadPacker<Measurer>);
+}
+
+TEST(MeasurerTests, DefaultConstructedIsZero) {
+  Measurer measurer;
+  EXPECT_EQ(measurer.current_bit(), 0);
+  EXPECT_EQ(measurer.capacity(), 0);
+}
+
+TEST(MeasurerTests, CountsBitsWithoutBuffer) {
+  Measurer measurer;
+  measurer.write_bits(0xffffffff, 32);
+  measurer.write_bits(1, 1);
+  measurer.write_bits(0, 0);
+  measurer.write_bits(5, 3);
+  EXPECT_EQ(measurer.current_bit(), 36);
+}
+
+TEST(MeasurerTests, MeasuresFundamentalsAtCompileTime) {
+  static_assert(measure_bits([](auto& measurer) {
+                  u8 a{};
+                  u16 b{};
+                  u32 c{};
+                  u64 d{};
+                  pack(measurer, a);
+                  pack(measurer, b);
+                  pack(measurer, c);
+                  pack(measurer, d);
+                }) == 120);
+  static_assert(measure_bits([](auto& measurer) {
+                  f32 a{};
+                  f64 b{};
+                  i32 c{};
+                  pack(measurer, a);
+                  pack(measurer, b);
+                  pack(measurer, c);
+                  pack(measurer, true);
+                }) == 129);
+}
+
+TEST(MeasurerTests, MeasuresRangesAndVarintsAtCompileTime) {
+  static_assert(measure_bits([](auto& measurer) {
+                  i32 value = 50;
+                  pack_range(measurer, value, -100, 100);
+                }) == 8);
+  static_assert(measure_bits([](auto& measurer) {
+                  pack_varint(measurer, 6u);
+                  pack_varint(measurer, -1);
+                }) == 8);
+}
+
+TEST(MeasurerTests, SpanMeasuredWithoutTouchingValues) {
+  std::array<u16, 1000> values{};
+  const auto bits = measure_bits([&](auto& measurer) {
+    pack_bits(measurer, std::span<const u16>{values}, 0, 11);
+  });
+  EXPECT_EQ(bits, 11000);
+}
+
+TEST(MeasurerTests, MatchesPackerOnMixedPayload) {
+  std::mt19937 rng{17};
+  std::uniform_int_distribution<i32> dist{-2000, 2000};
+
+  std::vector<i32> values(200);
+  for (auto& value : values) {
+    value = dist(rng);
+  }
+
+  expect_measured_matches_packed([&](auto& packer) {
+    for (i32 value : values) {
+      pack_varint(packer, value);
+      i32 baseline = 0;
+      pack(packer, value, baseline);
+    }
+    Pose pose{vec3{1.0f, 2.0f, 3.0f}, glm::identity<quat>()};
+    pack(packer, pose, QuantizePose<16, 9>{vec3{-10.0f}, vec3{10.0f}});
+  });
+}
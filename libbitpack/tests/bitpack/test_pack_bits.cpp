@@ -2,9 +2,11 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <glue/bitpack/pack_bits.hpp>
 #include <glue/types.hpp>
 #include <span>
+#include <vector>
 
 using namespace glue;
 using namespace glue::bitpack;
@@ -96,4 +98,88 @@ TEST(BitpackBitsTests, UnpacksValues) {
   i64 value_int = 0;
   pack_bits_wrap(unpacker, value_int, 10, 12);
   EXPECT_EQ(value_int, 2532);
-}
\ No newline at end of file
+}
+
+template <typename T>
+class BitpackBitsSpanTests : public ::testing::Test {};
+
+template <typename TPacker, typename TUnpacker>
+struct PackerPair {
+  using packer_t = TPacker;
+  using unpacker_t = TUnpacker;
+};
+
+template <typename TPacker>
+void flush_if_buffered(TPacker& packer) {
+  if constexpr (requires { packer.flush(); }) {
+    packer.flush();
+  }
+}
+
+using PackerPairs = ::testing::Types<PackerPair<Packer, Unpacker>,
+                                     PackerPair<StreamPacker, StreamUnpacker>>;
+TYPED_TEST_SUITE(BitpackBitsSpanTests, PackerPairs);
+
+TYPED_TEST(BitpackBitsSpanTests, SpanPackingMatchesPerElementPacking) {
+  using packer_t = typename TypeParam::packer_t;
+  using unpacker_t = typename TypeParam::unpacker_t;
+
+  for (u32 bits : {0u, 1u, 5u, 8u, 13u, 16u, 17u, 31u, 32u}) {
+    std::vector<u32> values;
+    for (u32 i = 0; i < 100; ++i) {
+      const u64 mask = (1ull << bits) - 1;
+      values.push_back(static_cast<u32>((i * 2654435761u) & mask) + 7);
+    }
+
+    // start with a misaligned 3 bit value and dirty buffers
+    std::vector<u32> expected(120, 0xffffffff);
+    Packer packer{expected};
+    packer.write_bits(0b101, 3);
+    for (auto value : values) {
+      pack_bits(packer, value, 7, bits);
+    }
+    packer.write_bits(0b11, 2);
+
+    std::vector<u32> actual(120, 0xffffffff);
+    packer_t span_packer{actual};
+    span_packer.write_bits(0b101, 3);
+    pack_bits(span_packer, std::span<const u32>{values}, 7, bits);
+    span_packer.write_bits(0b11, 2);
+    flush_if_buffered(span_packer);
+
+    EXPECT_EQ(span_packer.current_bit(), packer.current_bit());
+    const auto used_words = (packer.current_bit() + 31) / 32;
+    EXPECT_TRUE(std::equal(actual.begin(), actual.begin() + used_words,
+                           expected.begin()))
+        << "bits = " << bits;
+
+    unpacker_t unpacker{actual};
+    EXPECT_EQ(unpacker.read_bits(3), 0b101);
+    std::vector<u32> unpacked(values.size(), 0);
+    pack_bits(unpacker, std::span<u32>{unpacked}, 7, bits);
+    EXPECT_EQ(unpacker.read_bits(2), 0b11);
+    EXPECT_THAT(unpacked, ContainerEq(values)) << "bits = " << bits;
+  }
+}
+
+TYPED_TEST(BitpackBitsSpanTests, EmptySpanWritesNothing) {
+  using packer_t = typename TypeParam::packer_t;
+  using unpacker_t = typename TypeParam::unpacker_t;
+
+  std::array<u32, 1> data{{0}};
+  packer_t packer{data};
+  pack_bits(packer, std::span<const u16>{}, 0, 16);
+  EXPECT_EQ(packer.current_bit(), 0);
+
+  unpacker_t unpacker{data};
+  pack_bits(unpacker, std::span<u16>{}, 0, 16);
+  EXPECT_EQ(unpacker.current_bit(), 0);
+}
+
+TEST(BitpackBitsSpanDeathTests, WhenSpanValueOutsideBitRange_Dies) {
+  std::array<u32, 4> data{};
+  std::array<u16, 3> values{{1, 2, 40}};
+  Packer packer{data};
+  EXPECT_DEATH(pack_bits(packer, std::span<u16>{values}, 0, 5),
+               "Assertion.*");
+}
@@ -0,0 +1,149 @@
+#include <glog/logging.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <glue/bitpack/pack_delta.hpp>
+#include <glue/bitpack/pack_pose.hpp>
+#include <glue/types.hpp>
+#include <limits>
+
+using namespace glue;
+using namespace glue::bitpack;
+using namespace testing;
+
+namespace {
+/*
+ * Packs value against baseline, checks the bit cost and returns the
+ * unpacked value.
+ */
+template <typename T>
+T round_trip(T value, T baseline, std::size_t expected_bits) {
+  std::array<u32, 4> data{};
+
+  Packer packer{data};
+  pack(packer, value, baseline);
+  EXPECT_EQ(packer.current_bit(), expected_bits);
+
+  T unpacked{};
+  Unpacker unpacker{data};
+  pack(unpacker, unpacked, baseline);
+  EXPECT_EQ(unpacker.current_bit(), expected_bits);
+  return unpacked;
+}
+}  // namespace
+
+TEST(BitpackDeltaTests, UnchangedValueCostsOneBit) {
+  EXPECT_EQ(round_trip<u32>(1234, 1234, 1), 1234);
+  EXPECT_EQ(round_trip<i64>(-5, -5, 1), -5);
+  EXPECT_EQ(round_trip<u8>(7, 7, 1), 7);
+}
+
+TEST(BitpackDeltaTests, SmallDeltasUseSmallestSizeClass) {
+  // flag + 2 bit size class + 4 bit zigzag delta
+  EXPECT_EQ(round_trip<u32>(1235, 1234, 7), 1235);
+  EXPECT_EQ(round_trip<u32>(1233, 1234, 7), 1233);
+  EXPECT_EQ(round_trip<i16>(-3, 4, 7), -3);
+  EXPECT_EQ(round_trip<u64>(100007, 100000, 7), 100007);
+}
+
+TEST(BitpackDeltaTests, LargerDeltasUseLargerSizeClasses) {
+  EXPECT_EQ(round_trip<u32>(1334, 1234, 11), 1334);
+  EXPECT_EQ(round_trip<u32>(11234, 1234, 19), 11234);
+  EXPECT_EQ(round_trip<u32>(0xffff0000, 0, 35), 0xffff0000);
+  EXPECT_EQ(round_trip<u64>(0xffff'0000'0000ull, 1, 67), 0xffff'0000'0000ull);
+}
+
+TEST(BitpackDeltaTests, DeltaWrapsAroundIntegerLimits) {
+  constexpr auto kMaxU32 = std::numeric_limits<u32>::max();
+  EXPECT_EQ(round_trip<u32>(kMaxU32, 0, 7), kMaxU32);
+  EXPECT_EQ(round_trip<u32>(2, kMaxU32 - 1, 7), 2);
+
+  constexpr auto kMinI64 = std::numeric_limits<i64>::min();
+  constexpr auto kMaxI64 = std::numeric_limits<i64>::max();
+  EXPECT_EQ(round_trip<i64>(kMinI64, kMaxI64, 7), kMinI64);
+  EXPECT_EQ(round_trip<i64>(kMaxI64, kMinI64, 7), kMaxI64);
+}
+
+TEST(BitpackDeltaTests, SmallTypesNeverExceedTheirWidth) {
+  EXPECT_EQ(round_trip<u8>(255, 0, 7), 255);
+  EXPECT_EQ(round_trip<u8>(128, 0, 11), 128);
+  EXPECT_EQ(round_trip<i8>(-128, 127, 7), -128);
+}
+
+TEST(BitpackDeltaTests, FloatsSendFlagAndFullValue) {
+  EXPECT_EQ(round_trip<f32>(1.5f, 1.5f, 1), 1.5f);
+  EXPECT_EQ(round_trip<f32>(2.5f, 1.5f, 33), 2.5f);
+  EXPECT_EQ(round_trip<f64>(-2.5, 1.5, 65), -2.5);
+}
+
+TEST(BitpackDeltaTests, UnchangedPoseCostsOneBit) {
+  const QuantizePose<16, 9> quantize{vec3{-100.0f}, vec3{100.0f}};
+  const Pose baseline{vec3{1.0f, 2.0f, 3.0f},
+                      glm::angleAxis(0.5f, vec3{0.0f, 1.0f, 0.0f})};
+  std::array<u32, 4> data{};
+
+  Pose value = baseline;
+  Packer packer{data};
+  EXPECT_FALSE(pack(packer, value, baseline, quantize));
+  EXPECT_EQ(packer.current_bit(), 1);
+
+  Pose unpacked{};
+  Unpacker unpacker{data};
+  EXPECT_FALSE(pack(unpacker, unpacked, baseline, quantize));
+  EXPECT_EQ(unpacked.position, baseline.position);
+  EXPECT_EQ(unpacked.rotation, baseline.rotation);
+}
+
+TEST(BitpackDeltaTests, ChangedPoseSendsQuantizedPose) {
+  using Quantize = QuantizePose<16, 9>;
+  const Quantize quantize{vec3{-100.0f}, vec3{100.0f}};
+  const Pose baseline{vec3{1.0f, 2.0f, 3.0f}, glm::identity<quat>()};
+  std::array<u32, 4> data{};
+
+  Pose value{vec3{1.5f, 2.0f, 3.0f}, glm::identity<quat>()};
+  Packer packer{data};
+  EXPECT_TRUE(pack(packer, value, baseline, quantize));
+  EXPECT_EQ(packer.current_bit(), 1 + Quantize::kPackedBits);
+
+  Pose unpacked{};
+  Unpacker unpacker{data};
+  EXPECT_TRUE(pack(unpacker, unpacked, baseline, quantize));
+  EXPECT_NEAR(unpacked.position.x, 1.5f, 0.01f);
+}
+
+/*
+ * A message packed against the last acknowledged copy of itself.
+ */
+struct DeltaMessage {
+  u32 frame;
+  i32 score;
+  f32 health;
+
+  template <CPacker T>
+  friend constexpr void pack(T& packer, DeltaMessage& message,
+                             const DeltaMessage& baseline) {
+    pack(packer, message.frame, baseline.frame);
+    pack(packer, message.score, baseline.score);
+    pack(packer, message.health, baseline.health);
+  }
+};
+
+TEST(BitpackDeltaTests, MessageDeltaAgainstBaseline) {
+  const DeltaMessage baseline{100, 5000, 75.0f};
+  DeltaMessage message{101, 5000, 75.0f};
+  std::array<u32, 4> data{};
+
+  StreamPacker packer{data};
+  pack(packer, message, baseline);
+  packer.flush();
+  // frame: 1 + 2 + 4, score: 1, health: 1
+  EXPECT_EQ(packer.current_bit(), 9);
+
+  DeltaMessage unpacked{};
+  StreamUnpacker unpacker{data};
+  pack(unpacker, unpacked, baseline);
+  EXPECT_EQ(unpacked.frame, 101);
+  EXPECT_EQ(unpacked.score, 5000);
+  EXPECT_EQ(unpacked.health, 75.0f);
+}
@@ -0,0 +1,158 @@
+#include <glog/logging.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <glue/bitpack/pack_pose.hpp>
+#include <glue/types.hpp>
+#include <random>
+
+using namespace glue;
+using namespace glue::bitpack;
+using namespace testing;
+
+namespace {
+f32 rotation_error_radians(const quat& a, const quat& b) {
+  const f32 d = glm::clamp(std::abs(glm::dot(a, b)), 0.0f, 1.0f);
+  return 2.0f * std::acos(d);
+}
+
+quat random_rotation(std::mt19937& rng) {
+  std::normal_distribution<f32> dist;
+  return glm::normalize(quat{dist(rng), dist(rng), dist(rng), dist(rng)});
+}
+}  // namespace
+
+TEST(BitpackPoseTests, PackedSizesKnownAtCompileTime) {
+  static_assert(QuantizeVec3<16>::kPackedBits == 48);
+  static_assert(QuantizeQuat<9>::kPackedBits == 29);
+  static_assert(QuantizePose<16, 9>::kPackedBits == 77);
+  static_assert(QuantizePose<12, 8>::kPackedBits == 62);
+}
+
+TEST(BitpackPoseTests, PackVec3WritesExactBitBudget) {
+  std::array<u32, 4> data{};
+  const QuantizeVec3<10> quantize{vec3{-10.0f}, vec3{10.0f}};
+
+  Packer packer{data};
+  vec3 value{1.0f, -2.0f, 3.0f};
+  pack(packer, value, quantize);
+  EXPECT_EQ(packer.current_bit(), 30);
+}
+
+TEST(BitpackPoseTests, Vec3RoundTripsWithinQuantizationStep) {
+  std::array<u32, 4> data{};
+  const QuantizeVec3<16> quantize{vec3{-256.0f, 0.0f, -256.0f},
+                                  vec3{256.0f, 64.0f, 256.0f}};
+  const vec3 step = (quantize.max - quantize.min) / f32((1 << 16) - 1);
+
+  vec3 value{12.57f, 3.25f, -200.125f};
+  Packer packer{data};
+  pack(packer, value, quantize);
+
+  vec3 unpacked{0.0f};
+  Unpacker unpacker{data};
+  pack(unpacker, unpacked, quantize);
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_NEAR(unpacked[i], value[i], step[i]) << "component " << i;
+  }
+}
+
+TEST(BitpackPoseTests, Vec3OutsideBoundsIsClamped) {
+  std::array<u32, 4> data{};
+  const QuantizeVec3<8> quantize{vec3{-1.0f}, vec3{1.0f}};
+
+  vec3 value{-5.0f, 0.0f, 5.0f};
+  Packer packer{data};
+  pack(packer, value, quantize);
+
+  vec3 unpacked{0.0f};
+  Unpacker unpacker{data};
+  pack(unpacker, unpacked, quantize);
+
+  EXPECT_FLOAT_EQ(unpacked.x, -1.0f);
+  EXPECT_FLOAT_EQ(unpacked.z, 1.0f);
+
+  // only the packed copy is clamped
+  EXPECT_EQ(value, (vec3{-5.0f, 0.0f, 5.0f}));
+}
+
+TEST(BitpackPoseTests, IdentityQuatRoundTrips) {
+  std::array<u32, 2> data{};
+  quat value = glm::identity<quat>();
+
+  Packer packer{data};
+  pack(packer, value, QuantizeQuat<9>{});
+  EXPECT_EQ(packer.current_bit(), 29);
+
+  quat unpacked{0.0f, 0.0f, 0.0f, 0.0f};
+  Unpacker unpacker{data};
+  pack(unpacker, unpacked, QuantizeQuat<9>{});
+  EXPECT_LT(rotation_error_radians(unpacked, value), 0.01f);
+}
+
+TEST(BitpackPoseTests, QuatWithNegativeLargestComponentRoundTrips) {
+  std::array<u32, 2> data{};
+  quat value = glm::normalize(quat{-0.9f, 0.1f, -0.3f, 0.2f});
+
+  Packer packer{data};
+  pack(packer, value, QuantizeQuat<10>{});
+
+  quat unpacked{};
+  Unpacker unpacker{data};
+  pack(unpacker, unpacked, QuantizeQuat<10>{});
+  EXPECT_LT(rotation_error_radians(unpacked, value), 0.01f);
+}
+
+TEST(BitpackPoseTests, RandomQuatsRoundTripWithinTolerance) {
+  std::mt19937 rng{42};
+  std::array<u32, 2> data{};
+
+  for (int i = 0; i < 1000; ++i) {
+    quat value = random_rotation(rng);
+
+    Packer packer{data};
+    pack(packer, value, QuantizeQuat<9>{});
+
+    quat unpacked{};
+    Unpacker unpacker{data};
+    pack(unpacker, unpacked, QuantizeQuat<9>{});
+
+    ASSERT_NEAR(glm::length(unpacked), 1.0f, 1e-5f);
+    // 9 bits over [-0.707, 0.707] -> ~0.0028 per step, well under a degree
+    ASSERT_LT(rotation_error_radians(unpacked, value), glm::radians(1.0f))
+        << "iteration " << i;
+  }
+}
+
+TEST(BitpackPoseTests, PoseRoundTripsWithStreamPacker) {
+  std::mt19937 rng{7};
+  std::uniform_real_distribution<f32> position_dist{-100.0f, 100.0f};
+  using Quantize = QuantizePose<16, 9>;
+  const Quantize quantize{vec3{-128.0f}, vec3{128.0f}};
+
+  std::array<Pose, 20> poses;
+  for (auto& pose : poses) {
+    pose = Pose{vec3{position_dist(rng), position_dist(rng),
+                     position_dist(rng)},
+                random_rotation(rng)};
+  }
+
+  std::array<u32, (20 * Quantize::kPackedBits + 31) / 32> data{};
+  StreamPacker packer{data};
+  for (auto& pose : poses) {
+    pack(packer, pose, quantize);
+  }
+  packer.flush();
+  EXPECT_EQ(packer.current_bit(), 20 * Quantize::kPackedBits);
+
+  StreamUnpacker unpacker{data};
+  for (const auto& pose : poses) {
+    Pose unpacked{};
+    pack(unpacker, unpacked, quantize);
+    EXPECT_NEAR(glm::distance(unpacked.position, pose.position), 0.0f, 0.01f);
+    EXPECT_LT(rotation_error_radians(unpacked.rotation, pose.rotation),
+              glm::radians(1.0f));
+  }
+}
@@ -99,4 +99,28 @@ TEST(BitpackRangeTests, UnpackValues) {
   pack_range(unpacker, value_long, -1000000000000000015,
                      -1000000000000000000);
   EXPECT_EQ(value_long, -1000000000000000004);
-}
\ No newline at end of file
+}
+
+TEST(BitpackRangeTests, PackAndUnpackSpan) {
+  std::array<u32, 2> data{{0, 0}};
+  std::array<i16, 4> values{{-2000, -1519, 0, 1999}};
+
+  Packer packer{data};
+  pack_range(packer, std::span<i16>{values}, -2000, 2000);
+  EXPECT_EQ(packer.current_bit(), 48);
+  EXPECT_THAT(data, ElementsAre(0b000000000000'000111100001'01111101,
+                                0b0000'111110011111'0000000000000000));
+
+  std::array<i16, 4> unpacked{};
+  Unpacker unpacker{data};
+  pack_range(unpacker, std::span<i16>{unpacked}, -2000, 2000);
+  EXPECT_THAT(unpacked, ContainerEq(values));
+}
+
+TEST(BitpackRangeDeathTests, WhenSpanValueAtEnd_Dies) {
+  std::array<u32, 2> data;
+  std::array<u8, 3> values{{0, 5, 10}};
+  Packer packer{data};
+  EXPECT_DEATH(pack_range(packer, std::span<u8>{values}, 0, 10),
+               "Assertion.*");
+}
@@ -0,0 +1,169 @@
+#include <glog/logging.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <glue/bitpack/pack_varint.hpp>
+#include <glue/types.hpp>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace glue;
+using namespace glue::bitpack;
+using namespace testing;
+
+namespace {
+/*
+ * Packs value with code, checks the bit cost against varint_bits() and
+ * returns the unpacked value.
+ */
+template <typename T, typename Code = ExpGolomb<0>>
+T round_trip(T value, Code code = {}) {
+  std::array<u32, 8> data{};
+
+  Packer packer{data};
+  pack_varint(packer, value, code);
+  EXPECT_EQ(packer.current_bit(), varint_bits(value, code));
+
+  T unpacked{};
+  Unpacker unpacker{data};
+  pack_varint(unpacker, unpacked, code);
+  EXPECT_EQ(unpacker.current_bit(), packer.current_bit());
+  return unpacked;
+}
+
+template <typename T, typename Code>
+void expect_edge_values_round_trip(Code code) {
+  using limits = std::numeric_limits<T>;
+  const std::vector<T> values{
+      limits::min(), static_cast<T>(limits::min() + 1), T{0}, T{1}, T{2},
+      T{3},          static_cast<T>(limits::max() - 1), limits::max()};
+  for (T value : values) {
+    EXPECT_EQ(round_trip(value, code), value) << +value;
+  }
+  if constexpr (std::is_signed_v<T>) {
+    EXPECT_EQ(round_trip(T{-1}, code), T{-1});
+    EXPECT_EQ(round_trip(T{-2}, code), T{-2});
+  }
+}
+
+template <typename Code>
+void expect_all_types_round_trip(Code code) {
+  expect_edge_values_round_trip<u8>(code);
+  expect_edge_values_round_trip<u16>(code);
+  expect_edge_values_round_trip<u32>(code);
+  expect_edge_values_round_trip<u64>(code);
+  expect_edge_values_round_trip<i8>(code);
+  expect_edge_values_round_trip<i16>(code);
+  expect_edge_values_round_trip<i32>(code);
+  expect_edge_values_round_trip<i64>(code);
+}
+}  // namespace
+
+TEST(BitpackVarintTests, EliasGammaSizes) {
+  static_assert(varint_bits(0u) == 1);
+  static_assert(varint_bits(1u) == 3);
+  static_assert(varint_bits(2u) == 3);
+  static_assert(varint_bits(3u) == 5);
+  static_assert(varint_bits(6u) == 5);
+  static_assert(varint_bits(7u) == 7);
+  static_assert(varint_bits(~u64{0}) == 129);
+}
+
+TEST(BitpackVarintTests, SignedValuesAreZigzagMapped) {
+  static_assert(varint_bits(0) == 1);
+  static_assert(varint_bits(-1) == 3);
+  static_assert(varint_bits(1) == 3);
+  static_assert(varint_bits(-2) == 5);
+  static_assert(varint_bits(std::numeric_limits<i32>::min()) ==
+                varint_bits(std::numeric_limits<u32>::max()));
+}
+
+TEST(BitpackVarintTests, ExpGolombOrderSizes) {
+  static_assert(varint_bits(0u, ExpGolomb<2>{}) == 3);
+  static_assert(varint_bits(3u, ExpGolomb<2>{}) == 3);
+  static_assert(varint_bits(4u, ExpGolomb<2>{}) == 5);
+  static_assert(varint_bits(11u, ExpGolomb<2>{}) == 5);
+  static_assert(varint_bits(12u, ExpGolomb<2>{}) == 7);
+}
+
+TEST(BitpackVarintTests, ChunkedSizes) {
+  static_assert(varint_bits(0u, Chunked<4>{}) == 5);
+  static_assert(varint_bits(15u, Chunked<4>{}) == 5);
+  static_assert(varint_bits(16u, Chunked<4>{}) == 10);
+  static_assert(varint_bits(~u64{0}, Chunked<4>{}) == 80);
+  static_assert(varint_bits(~u64{0}, Chunked<7>{}) == 80);
+  static_assert(varint_bits(~u64{0}, Chunked<32>{}) == 66);
+}
+
+TEST(BitpackVarintTests, EliasGammaWritesExpectedBits) {
+  std::array<u32, 1> data{};
+  Packer packer{data};
+  pack_varint(packer, 0u);  // 1
+  pack_varint(packer, 4u);  // 00101
+  pack_varint(packer, -1);  // 010
+  EXPECT_EQ(packer.current_bit(), 9);
+  EXPECT_EQ(data[0], 0b100101010u << 23);
+}
+
+TEST(BitpackVarintTests, EdgeValuesRoundTripEliasGamma) {
+  expect_all_types_round_trip(ExpGolomb<0>{});
+}
+
+TEST(BitpackVarintTests, EdgeValuesRoundTripExpGolomb) {
+  expect_all_types_round_trip(ExpGolomb<1>{});
+  expect_all_types_round_trip(ExpGolomb<5>{});
+  expect_all_types_round_trip(ExpGolomb<31>{});
+  expect_all_types_round_trip(ExpGolomb<32>{});
+  expect_all_types_round_trip(ExpGolomb<63>{});
+}
+
+TEST(BitpackVarintTests, EdgeValuesRoundTripChunked) {
+  expect_all_types_round_trip(Chunked<1>{});
+  expect_all_types_round_trip(Chunked<4>{});
+  expect_all_types_round_trip(Chunked<7>{});
+  expect_all_types_round_trip(Chunked<32>{});
+}
+
+TEST(BitpackVarintTests, PowersOfTwoRoundTrip) {
+  for (u32 shift = 0; shift < 64; ++shift) {
+    const u64 value = u64{1} << shift;
+    EXPECT_EQ(round_trip(value), value);
+    EXPECT_EQ(round_trip(value - 1), value - 1);
+    EXPECT_EQ(round_trip(value, ExpGolomb<3>{}), value);
+    EXPECT_EQ(round_trip(value, Chunked<5>{}), value);
+  }
+}
+
+TEST(BitpackVarintTests, MixedStreamRoundTripsWithStreamPacker) {
+  std::mt19937 rng{99};
+  std::geometric_distribution<i32> small{0.2};
+  std::bernoulli_distribution negative{0.5};
+
+  std::vector<i32> values(500);
+  for (auto& value : values) {
+    value = negative(rng) ? -small(rng) : small(rng);
+  }
+
+  std::array<u32, 512> data{};
+  StreamPacker packer{data};
+  u64 expected_bits = 0;
+  for (i32 value : values) {
+    pack_varint(packer, value);
+    pack_varint(packer, value, Chunked<3>{});
+    expected_bits += varint_bits(value) + varint_bits(value, Chunked<3>{});
+  }
+  packer.flush();
+  EXPECT_EQ(packer.current_bit(), expected_bits);
+
+  StreamUnpacker unpacker{data};
+  for (i32 value : values) {
+    i32 a = 0;
+    i32 b = 0;
+    pack_varint(unpacker, a);
+    pack_varint(unpacker, b, Chunked<3>{});
+    ASSERT_EQ(a, value);
+    ASSERT_EQ(b, value);
+  }
+}
@@ -2,6 +2,7 @@
 #include <gtest/gtest.h>
 
 #include <array>
+#include <glue/bitpack/pack_fundamental.hpp>
 #include <glue/bitpack/packer.hpp>
 
 using namespace glue;
@@ -11,7 +12,9 @@ using namespace ::testing;
 template <std::derived_from<glue::bitpack::detail::BasePacker> T>
 class BasePackerTests : public ::testing::Test {};
 
-using PackerTypes = ::testing::Types<Packer, Unpacker>;
+using PackerTypes =
+    ::testing::Types<Packer, Unpacker, StreamPacker, StreamUnpacker,
+                     CheckedUnpacker>;
 TYPED_TEST_SUITE(BasePackerTests, PackerTypes);
 
 TYPED_TEST(BasePackerTests, WhenDefaultConstructed_ZeroCapacityAndSizes) {
@@ -67,6 +70,13 @@ TEST(PackerTests, Writing0OverwritesExisting1Bits) {
   EXPECT_THAT(data, ElementsAre(0x0ab0f510));
 }
 
+TEST(PackerTests, Writing32BitsOverwritesExistingBits) {
+  std::array<u32, 1> data{{0xffffffff}};
+  Packer packer{data};
+  packer.write_bits(0x12345678, 32);
+  EXPECT_THAT(data, ElementsAre(0x12345678));
+}
+
 TEST(PackerTests, WriteExactly32BitsAligned) {
   std::array<u32, 1> data{{0}};
   Packer packer{data};
@@ -128,6 +138,79 @@ TEST(UnpackerTests, Read16BitsThenRead32Bits) {
   EXPECT_EQ(b, 0xf5f5f5f5);
 }
 
+TEST(UnpackerTests, PeekDoesNotAdvance) {
+  std::array<u32, 2> data{{0xabcd1234, 0x5678ef00}};
+  Unpacker unpacker{data};
+
+  EXPECT_EQ(unpacker.peek_bits(8), 0xab);
+  EXPECT_EQ(unpacker.peek_bits(16), 0xabcd);
+  EXPECT_EQ(unpacker.current_bit(), 0);
+
+  unpacker.read_bits(20);
+  // crosses the word boundary
+  EXPECT_EQ(unpacker.peek_bits(24), 0x234567);
+  EXPECT_EQ(unpacker.peek_bits(0), 0);
+  EXPECT_EQ(unpacker.read_bits(24), 0x234567);
+  EXPECT_EQ(unpacker.current_bit(), 44);
+}
+
+TEST(UnpackerTests, SkipBitsAdvancesPastWords) {
+  std::array<u32, 3> data{{0, 0, 0xf0000000}};
+  Unpacker unpacker{data};
+  unpacker.skip_bits(64);
+  EXPECT_EQ(unpacker.read_bits(4), 0xf);
+  unpacker.skip_bits(28);
+  EXPECT_EQ(unpacker.current_bit(), unpacker.capacity_bits());
+}
+
+TEST(UnpackerTests, SeekAndCheckpointRestore) {
+  std::array<u32, 2> data{{0x01234567, 0x89abcdef}};
+  Unpacker unpacker{data};
+
+  unpacker.seek(36);
+  EXPECT_EQ(unpacker.read_bits(8), 0x9a);
+
+  const auto checkpoint = unpacker.checkpoint();
+  EXPECT_EQ(unpacker.read_bits(12), 0xbcd);
+  unpacker.restore(checkpoint);
+  EXPECT_EQ(unpacker.current_bit(), 44);
+  EXPECT_EQ(unpacker.read_bits(12), 0xbcd);
+
+  unpacker.seek(4);
+  EXPECT_EQ(unpacker.read_bits(4), 0x1);
+}
+
+TEST(UnpackerTests, RemainderContinuesWhereUnpackerIs) {
+  std::array<u32, 4> data{};
+  Packer packer{data};
+  u8 type = 3;
+  u32 a = 0xdeadbeef;
+  u64 b = 0x0123456789abcdefull;
+  pack(packer, type);
+  pack(packer, a);
+  pack(packer, b);
+
+  Unpacker dispatcher{data};
+  u8 type2{};
+  pack(dispatcher, type2);
+  EXPECT_EQ(type2, 3);
+
+  Unpacker worker = dispatcher.remainder();
+  EXPECT_EQ(worker.current_bit(), 8);
+  EXPECT_EQ(worker.capacity(), 4);
+  u32 a2{};
+  u64 b2{};
+  pack(worker, a2);
+  pack(worker, b2);
+  EXPECT_EQ(a2, a);
+  EXPECT_EQ(b2, b);
+
+  dispatcher.skip_bits(32);
+  Unpacker second = dispatcher.remainder();
+  EXPECT_EQ(second.capacity(), 3);
+  EXPECT_EQ(second.current_bit(), 8);
+}
+
 TEST(PackerDeathTests, WhenWritingMoreThan32Bits_Die) {
   std::array<u32, 24> data;
   Packer packer{data};
@@ -154,4 +237,17 @@ TEST(UnpackerDeathTests, WhenReadingOutOfBounds_Die) {
   packer.read_bits(32);
   packer.read_bits(16);
   EXPECT_DEATH(packer.read_bits(32), "Assertion.*");
-}
\ No newline at end of file
+}
+
+TEST(UnpackerDeathTests, WhenSkippingOutOfBounds_Die) {
+  std::array<u32, 2> data;
+  Unpacker packer{data};
+  packer.skip_bits(60);
+  EXPECT_DEATH(packer.skip_bits(5), "Assertion.*");
+}
+
+TEST(UnpackerDeathTests, WhenSeekingOutOfBounds_Die) {
+  std::array<u32, 2> data;
+  Unpacker packer{data};
+  EXPECT_DEATH(packer.seek(65), "Assertion.*");
+}
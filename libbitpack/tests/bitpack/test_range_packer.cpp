@@ -0,0 +1,242 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <glue/bitpack/bitpack.hpp>
+#include <glue/bitpack/pack_quantize.hpp>
+#include <glue/bitpack/range_packer.hpp>
+#include <random>
+#include <vector>
+
+using namespace glue;
+using namespace glue::bitpack;
+using namespace ::testing;
+
+namespace {
+struct Write {
+  u32 value;
+  u32 bits;
+};
+
+std::vector<Write> random_writes(std::size_t count, u32 seed) {
+  std::mt19937 rng{seed};
+  std::uniform_int_distribution<u32> bits_dist{0, 32};
+  std::uniform_int_distribution<u32> value_dist;
+
+  std::vector<Write> writes;
+  writes.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    const u32 bits = bits_dist(rng);
+    const u32 mask = static_cast<u32>((1ull << bits) - 1);
+    writes.push_back({value_dist(rng) & mask, bits});
+  }
+  return writes;
+}
+
+struct Entity {
+  u16 id;
+  bool active;
+  i32 x, y, z;
+};
+
+template <CPacker TPacker>
+void pack(TPacker& packer, Entity& entity) {
+  pack_range(packer, entity.id, 0, 1024);
+  if (pack(packer, entity.active)) {
+    pack_range(packer, entity.x, -4096, 4096);
+    pack_range(packer, entity.y, -4096, 4096);
+    pack_range(packer, entity.z, -4096, 4096);
+  }
+}
+
+/*
+ * Mostly inactive entities near the origin, like resting cubes.
+ */
+std::vector<Entity> skewed_entities(std::size_t count) {
+  std::mt19937 rng{8};
+  std::bernoulli_distribution active{0.1};
+  std::normal_distribution<f32> position{0.0f, 8.0f};
+
+  std::vector<Entity> entities(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    auto& entity = entities[i];
+    entity.id = static_cast<u16>(i);
+    entity.active = active(rng);
+    entity.x = entity.active ? static_cast<i32>(position(rng)) : 0;
+    entity.y = entity.active ? static_cast<i32>(position(rng)) : 0;
+    entity.z = entity.active ? static_cast<i32>(position(rng)) : 0;
+  }
+  return entities;
+}
+}  // namespace
+
+TEST(RangePackerTests, SatisfiesPackerConcepts) {
+  static_assert(CWritePacker<RangePacker>);
+  static_assert(CReadPacker<RangeUnpacker>);
+}
+
+TEST(RangePackerTests, EmptyStreamFlushesToFiveBytes) {
+  std::array<u32, 2> data{};
+  RangePacker packer{data};
+  packer.flush();
+  EXPECT_EQ(packer.current_bit(), 0);
+  EXPECT_EQ(packer.size_bytes(), 5);
+}
+
+TEST(RangePackerTests, CurrentBitTracksUncompressedPosition) {
+  std::array<u32, 4> data{};
+  RangePacker packer{data};
+  packer.write_bits(0xabcd, 16);
+  packer.write_bits(1, 1);
+  packer.write_bits(0, 0);
+  EXPECT_EQ(packer.current_bit(), 17);
+}
+
+TEST(RangePackerTests, GivenRandomWrites_ReadsBackSameValues) {
+  const auto writes = random_writes(1000, 777);
+
+  // random data doesn't compress, leave room for coder overhead
+  std::vector<u32> data(1000);
+  RangePacker packer{data};
+  for (const auto& write : writes) {
+    packer.write_bits(write.value, write.bits);
+  }
+  packer.flush();
+  EXPECT_FALSE(packer.overflowed());
+
+  RangeUnpacker unpacker{data};
+  for (const auto& write : writes) {
+    ASSERT_EQ(unpacker.read_bits(write.bits), write.value);
+  }
+  EXPECT_EQ(unpacker.current_bit(), packer.current_bit());
+}
+
+TEST(RangePackerTests, GivenIncompressibleData_TightBufferOverflows) {
+  const auto writes = random_writes(1000, 4242);
+  const std::size_t bits = measure_bits([&](auto& measurer) {
+    for (const auto& write : writes) {
+      measurer.write_bits(write.value, write.bits);
+    }
+  });
+
+  // exactly what Packer would need, plus a guard word that must stay intact
+  std::vector<u32> data((bits + 31) / 32 + 1, 0xabababab);
+  RangePacker packer{std::span{data}.first(data.size() - 1)};
+  for (const auto& write : writes) {
+    packer.write_bits(write.value, write.bits);
+  }
+  packer.flush();
+
+  EXPECT_TRUE(packer.overflowed());
+  EXPECT_GT(packer.size_bytes(), (data.size() - 1) * sizeof(u32));
+  EXPECT_EQ(data.back(), 0xabababab);
+}
+
+TEST(RangePackerTests, AllOnesAndAllZerosRoundTrip) {
+  std::vector<u32> data(256);
+  RangePacker packer{data};
+  for (int i = 0; i < 2000; ++i) {
+    packer.write_bits(0xffffffff, 32);
+    packer.write_bits(0, 7);
+  }
+  packer.flush();
+
+  RangeUnpacker unpacker{data};
+  for (int i = 0; i < 2000; ++i) {
+    ASSERT_EQ(unpacker.read_bits(32), 0xffffffff);
+    ASSERT_EQ(unpacker.read_bits(7), 0);
+  }
+  // adaptive probabilities never reach certainty, but get close
+  EXPECT_LT(packer.size_bytes() * 8, packer.current_bit() / 16);
+}
+
+TEST(RangePackerTests, PackOverloadsRoundTrip) {
+  std::array<u32, 16> data{};
+
+  u8 a = 211;
+  i16 b = -1519;
+  u32 c = 0xdeadbeef;
+  u64 d = 53125123512ull;
+  f32 e = -121.25f;
+  bool f = true;
+  u16 g = 5187;
+  f32 h = 12.57f;
+
+  RangePacker packer{data};
+  pack(packer, a);
+  pack(packer, b);
+  pack(packer, c);
+  pack(packer, d);
+  pack(packer, e);
+  pack(packer, f);
+  pack_range(packer, g, 5000, 6024);
+  pack_quantize(packer, h, -20.0f, 20.0f, 20);
+  packer.flush();
+
+  u8 a2{};
+  i16 b2{};
+  u32 c2{};
+  u64 d2{};
+  f32 e2{};
+  bool f2{};
+  u16 g2{};
+  f32 h2{};
+
+  RangeUnpacker unpacker{data};
+  pack(unpacker, a2);
+  pack(unpacker, b2);
+  pack(unpacker, c2);
+  pack(unpacker, d2);
+  pack(unpacker, e2);
+  pack(unpacker, f2);
+  pack_range(unpacker, g2, 5000, 6024);
+  pack_quantize(unpacker, h2, -20.0f, 20.0f, 20);
+
+  EXPECT_EQ(a2, a);
+  EXPECT_EQ(b2, b);
+  EXPECT_EQ(c2, c);
+  EXPECT_EQ(d2, d);
+  EXPECT_EQ(e2, e);
+  EXPECT_EQ(f2, f);
+  EXPECT_EQ(g2, g);
+  EXPECT_NEAR(h2, h, 40.0f / (1 << 20));
+}
+
+TEST(RangePackerTests, SkewedMessagesCompressBelowPlainPacker) {
+  auto entities = skewed_entities(1024);
+
+  std::vector<u32> plain_data(4096);
+  Packer plain{plain_data};
+  std::vector<u32> range_data(4096);
+  RangePacker packer{range_data};
+  for (auto& entity : entities) {
+    pack(plain, entity);
+    pack(packer, entity);
+  }
+  packer.flush();
+
+  EXPECT_EQ(packer.current_bit(), plain.current_bit());
+  EXPECT_LT(packer.size_bytes() * 8, plain.current_bit());
+
+  RangeUnpacker unpacker{range_data};
+  for (const auto& entity : entities) {
+    Entity unpacked{};
+    pack(unpacker, unpacked);
+    ASSERT_EQ(unpacked.id, entity.id);
+    ASSERT_EQ(unpacked.active, entity.active);
+    if (entity.active) {
+      ASSERT_EQ(unpacked.x, entity.x);
+      ASSERT_EQ(unpacked.y, entity.y);
+      ASSERT_EQ(unpacked.z, entity.z);
+    }
+  }
+}
+
+TEST(RangeUnpackerTests, TruncatedBufferDoesNotReadOutOfBounds) {
+  std::array<u32, 1> data{0x12345678};
+  RangeUnpacker unpacker{data};
+  for (int i = 0; i < 100; ++i) {
+    unpacker.read_bits(32);
+  }
+  EXPECT_EQ(unpacker.current_bit(), 3200);
+}
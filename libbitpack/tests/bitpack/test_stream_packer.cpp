@@ -0,0 +1,224 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <glue/bitpack/bitpack.hpp>
+#include <glue/bitpack/pack_quantize.hpp>
+#include <random>
+#include <vector>
+
+using namespace glue;
+using namespace glue::bitpack;
+using namespace ::testing;
+
+namespace {
+struct Write {
+  u32 value;
+  u32 bits;
+};
+
+std::vector<Write> random_writes(std::size_t count, u32 seed) {
+  std::mt19937 rng{seed};
+  std::uniform_int_distribution<u32> bits_dist{0, 32};
+  std::uniform_int_distribution<u32> value_dist;
+
+  std::vector<Write> writes;
+  writes.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    const u32 bits = bits_dist(rng);
+    const u32 mask = static_cast<u32>((1ull << bits) - 1);
+    writes.push_back({value_dist(rng) & mask, bits});
+  }
+  return writes;
+}
+
+std::size_t words_needed(const std::vector<Write>& writes) {
+  std::size_t bits = 0;
+  for (const auto& write : writes) {
+    bits += write.bits;
+  }
+  return (bits + 31) / 32;
+}
+}  // namespace
+
+TEST(StreamPackerTests, WriteBitsCorrectly) {
+  std::array<u32, 2> data{{0, 0}};
+  StreamPacker packer{data};
+
+  packer.write_bits(0b0101'0110'1111'0101, 16);
+  EXPECT_EQ(packer.current_bit(), 16);
+
+  packer.write_bits(0b1111'0101'11, 10);
+  EXPECT_EQ(packer.current_bit(), 26);
+
+  packer.write_bits(0x0, 32);
+  EXPECT_EQ(packer.current(), 1);
+  EXPECT_EQ(packer.current_bit(), 58);
+
+  packer.write_bits(0b11, 2);
+  EXPECT_EQ(packer.current_bit(), 60);
+
+  packer.flush();
+  EXPECT_THAT(data, ElementsAre(0b0101'0110'1111'0101'1111'0101'1100'0000,
+                                0b0000'0000'0000'0000'0000'0000'0011'0000));
+}
+
+TEST(StreamPackerTests, PartialWordOnlyStoredOnFlush) {
+  std::array<u32, 2> data{{0, 0}};
+  StreamPacker packer{data};
+
+  packer.write_bits(0xabab, 16);
+  packer.write_bits(0xf5f5f5f5, 32);
+  EXPECT_THAT(data, ElementsAre(0xababf5f5, 0));
+
+  packer.flush();
+  EXPECT_THAT(data, ElementsAre(0xababf5f5, 0xf5f50000));
+}
+
+TEST(StreamPackerTests, WritingContinuesAfterFlush) {
+  std::array<u32, 1> data{{0}};
+  StreamPacker packer{data};
+
+  packer.write_bits(0xab, 8);
+  packer.flush();
+  EXPECT_THAT(data, ElementsAre(0xab000000));
+
+  packer.write_bits(0xcdef12, 24);
+  packer.flush();
+  EXPECT_THAT(data, ElementsAre(0xabcdef12));
+}
+
+TEST(StreamPackerTests, OverwritesExistingBitsWithoutClearing) {
+  std::array<u32, 2> data{{0xffffffff, 0xffffffff}};
+  StreamPacker packer{data};
+  packer.write_bits(0x0, 4);
+  packer.write_bits(0xab, 8);
+  packer.write_bits(0x0f510, 20);
+  packer.write_bits(0x1, 4);
+  packer.flush();
+  EXPECT_THAT(data, ElementsAre(0x0ab0f510, 0x10000000));
+}
+
+TEST(StreamPackerTests, GivenRandomWrites_BitIdenticalToPacker) {
+  const auto writes = random_writes(1000, 1234);
+  const auto words = words_needed(writes);
+
+  std::vector<u32> expected(words, 0);
+  Packer packer{expected};
+  for (const auto& write : writes) {
+    packer.write_bits(write.value, write.bits);
+  }
+
+  std::vector<u32> actual(words, 0);
+  StreamPacker stream_packer{actual};
+  for (const auto& write : writes) {
+    stream_packer.write_bits(write.value, write.bits);
+  }
+  stream_packer.flush();
+
+  EXPECT_EQ(stream_packer.current_bit(), packer.current_bit());
+  EXPECT_THAT(actual, ContainerEq(expected));
+}
+
+TEST(StreamUnpackerTests, ReadBitsCorrectly) {
+  std::array<u32, 2> data{{0b0101'0110'1111'0101'1111'0101'1100'0000,
+                           0b0000'0000'0000'0000'0000'0000'0011'0000}};
+  StreamUnpacker unpacker{data};
+
+  EXPECT_EQ(unpacker.read_bits(16), 0b0101'0110'1111'0101);
+  EXPECT_EQ(unpacker.current_bit(), 16);
+
+  EXPECT_EQ(unpacker.read_bits(10), 0b1111'0101'11);
+  EXPECT_EQ(unpacker.current_bit(), 26);
+
+  EXPECT_EQ(unpacker.read_bits(32), 0);
+  EXPECT_EQ(unpacker.current(), 1);
+  EXPECT_EQ(unpacker.current_bit(), 58);
+
+  EXPECT_EQ(unpacker.read_bits(2), 0b11);
+  EXPECT_EQ(unpacker.current_bit(), 60);
+}
+
+TEST(StreamUnpackerTests, GivenRandomWrites_ReadsBackSameValues) {
+  const auto writes = random_writes(1000, 4321);
+
+  std::vector<u32> data(words_needed(writes), 0);
+  Packer packer{data};
+  for (const auto& write : writes) {
+    packer.write_bits(write.value, write.bits);
+  }
+
+  StreamUnpacker unpacker{data};
+  for (const auto& write : writes) {
+    ASSERT_EQ(unpacker.read_bits(write.bits), write.value);
+  }
+  EXPECT_EQ(unpacker.current_bit(), packer.current_bit());
+}
+
+TEST(StreamPackerTests, PackOverloadsRoundTrip) {
+  std::array<u32, 8> data{};
+
+  u8 a = 211;
+  i16 b = -1519;
+  u32 c = 0xdeadbeef;
+  u64 d = 53125123512ull;
+  f32 e = -121.25f;
+  bool f = true;
+  u16 g = 5187;
+  f32 h = 12.57f;
+
+  StreamPacker packer{data};
+  pack(packer, a);
+  pack(packer, b);
+  pack(packer, c);
+  pack(packer, d);
+  pack(packer, e);
+  pack(packer, f);
+  pack_range(packer, g, 5000, 6024);
+  pack_quantize(packer, h, -20.0f, 20.0f, 20);
+  packer.flush();
+
+  u8 a2{};
+  i16 b2{};
+  u32 c2{};
+  u64 d2{};
+  f32 e2{};
+  bool f2{};
+  u16 g2{};
+  f32 h2{};
+
+  StreamUnpacker unpacker{data};
+  pack(unpacker, a2);
+  pack(unpacker, b2);
+  pack(unpacker, c2);
+  pack(unpacker, d2);
+  pack(unpacker, e2);
+  pack(unpacker, f2);
+  pack_range(unpacker, g2, 5000, 6024);
+  pack_quantize(unpacker, h2, -20.0f, 20.0f, 20);
+
+  EXPECT_EQ(a2, a);
+  EXPECT_EQ(b2, b);
+  EXPECT_EQ(c2, c);
+  EXPECT_EQ(d2, d);
+  EXPECT_EQ(e2, e);
+  EXPECT_EQ(f2, f);
+  EXPECT_EQ(g2, g);
+  EXPECT_NEAR(h2, h, 0.05f);
+}
+
+TEST(StreamPackerDeathTests, WhenWritingOutOfBounds_Die) {
+  std::array<u32, 2> data;
+  StreamPacker packer{data};
+  packer.write_bits(0x0, 32);
+  packer.write_bits(0x0, 16);
+  EXPECT_DEATH(packer.write_bits(0x0, 32), "Assertion.*");
+}
+
+TEST(StreamUnpackerDeathTests, WhenReadingOutOfBounds_Die) {
+  std::array<u32, 2> data;
+  StreamUnpacker unpacker{data};
+  unpacker.read_bits(32);
+  unpacker.read_bits(16);
+  EXPECT_DEATH(unpacker.read_bits(32), "Assertion.*");
+}
@@ -34,7 +34,7 @@ class ObjectID {
 
 template <>
 struct std::hash<glue::objects::ObjectID> {
-  constexpr std::size_t operator()(glue::objects::ObjectID id) const noexcept {
+  std::size_t operator()(glue::objects::ObjectID id) const noexcept {
     return std::hash<glue::u32>{}(id.value());
   }
 };
\ No newline at end of file
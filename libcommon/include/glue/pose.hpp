@@ -13,13 +13,13 @@ struct Pose {
   constexpr Pose(vec3 position, quat rotation) noexcept
       : position{position}, rotation{rotation} {}
 
-  constexpr mat4 model_matrix() const noexcept {
+  mat4 model_matrix() const noexcept {
     return glm::translate(glm::identity<mat4>(), position) *
            glm::toMat4(rotation);
   }
 };
 
-inline constexpr static Pose lerp(const Pose& pose_a, const Pose& pose_b,
+inline static Pose lerp(const Pose& pose_a, const Pose& pose_b,
                                   float a) {
   return Pose{glm::mix(pose_a.position, pose_b.position, a),
               glm::slerp(pose_a.rotation, pose_b.rotation, a)};
@@ -7,6 +7,9 @@
 namespace glue {
 class PresenceWindow final {
  public:
+  // flags kept for the indices before latest()
+  static constexpr u32 kWindowSize = 32;
+
   constexpr PresenceWindow() noexcept = default;
   constexpr PresenceWindow(u32 index, u32 flags) noexcept
       : index_{index}, presence_{flags} {}
@@ -23,23 +26,25 @@ class PresenceWindow final {
     const auto& [smaller, bigger] = windows;
 
     if (bigger.oldest() > smaller.latest()) {
-      return {bigger.latest(), 0};
+      return bigger;
     }
 
     // diff is guaranteed to be at least 1, because we quit early if a.latest()
-    // == b.latest()
+    // == b.latest(), and at most kWindowSize, because we quit early above.
+    // Shifting a u32 by 32 is undefined, at kWindowSize all flags fall out.
     const auto diff = bigger.latest() - smaller.latest();
     const u32 index_flag = 1u << (diff - 1);
-    const u32 shifted_flags = smaller.present_flags() << diff;
+    const u32 shifted_flags =
+        diff < kWindowSize ? smaller.present_flags() << diff : 0;
     return {bigger.latest(),
             index_flag | shifted_flags | bigger.present_flags()};
   }
 
   constexpr u32 oldest() const noexcept {
-    if (latest() < 32) {
+    if (latest() < kWindowSize) {
       return 0;
     }
-    return latest() - 32;
+    return latest() - kWindowSize;
   }
   constexpr u32 latest() const noexcept { return index_; }
   constexpr u32 present_flags() const noexcept { return presence_; }
@@ -54,8 +59,11 @@ class PresenceWindow final {
 
     if (index > latest()) {
       const u32 diff = index - latest();
-      if (diff > 32) {
+      if (diff > kWindowSize) {
         presence_ = 0;
+      } else if (diff == kWindowSize) {
+        // only the old latest is left, shifting a u32 by 32 is undefined
+        presence_ = 1u << (kWindowSize - 1);
       } else {
         const u32 index_flag = 1u << (diff - 1);
         const u32 shifted_flags = presence_ << diff;
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <concepts>
+#include <glue/typedefs.hpp>
+#include <type_traits>
+
+namespace glue {
+/*
+ * Wraparound-safe ordering for sequence numbers (RFC 1982): a is newer than
+ * b if it's less than half the range ahead of b, modulo the range.
+ *
+ * sequence_greater_than<u16>(1, 65535) is true.
+ */
+template <std::unsigned_integral T>
+inline constexpr bool sequence_greater_than(T a, T b) noexcept {
+  using Signed = std::make_signed_t<T>;
+  return static_cast<Signed>(static_cast<T>(a - b)) > 0;
+}
+
+template <std::unsigned_integral T>
+inline constexpr bool sequence_less_than(T a, T b) noexcept {
+  return sequence_greater_than(b, a);
+}
+
+/*
+ * Full index for a 16-bit sequence number: the one closest to reference
+ * with the same low 16 bits. Never goes below 0, so sequences near the
+ * start are read as ahead of reference rather than wrapping under it.
+ */
+inline constexpr u32 unwrap_sequence(u16 sequence, u32 reference) noexcept {
+  const auto delta = static_cast<i16>(
+      static_cast<u16>(sequence - static_cast<u16>(reference)));
+  if (delta < 0 && reference < static_cast<u32>(-delta)) {
+    return reference + static_cast<u16>(delta);
+  }
+  return reference + static_cast<u32>(static_cast<i32>(delta));
+}
+}  // namespace glue
@@ -70,15 +70,27 @@ TEST(PresenceWindowTests, CombineNoOverlap) {
   PresenceWindow a{1224, 0b11100011100011100011100011100011};
   PresenceWindow b{2000, 0b00001000001000001000001000001000};
 
+  // a has nothing to add, b is kept as is
   auto combined_0 = PresenceWindow::combine(a, b);
   EXPECT_EQ(combined_0.latest(), 2000);
   EXPECT_EQ(combined_0.oldest(), 1968);
-  EXPECT_EQ(combined_0.present_flags(), 0);
+  EXPECT_EQ(combined_0.present_flags(), b.present_flags());
 
   auto combined_1 = PresenceWindow::combine(b, a);
-  EXPECT_EQ(combined_0.latest(), 2000);
-  EXPECT_EQ(combined_0.oldest(), 1968);
-  EXPECT_EQ(combined_0.present_flags(), 0);
+  EXPECT_EQ(combined_1.latest(), 2000);
+  EXPECT_EQ(combined_1.oldest(), 1968);
+  EXPECT_EQ(combined_1.present_flags(), b.present_flags());
+}
+
+TEST(PresenceWindowTests, CombineWindowSizeApart) {
+  PresenceWindow a{100, 0xffffffff};
+  PresenceWindow b{132, 0b101};
+
+  // only a's latest is still in b's window, as its oldest
+  auto combined = PresenceWindow::combine(a, b);
+  EXPECT_EQ(combined.latest(), 132);
+  EXPECT_EQ(combined.present_flags(), 0x80000005);
+  EXPECT_EQ(PresenceWindow::combine(b, a).present_flags(), 0x80000005);
 }
 
 TEST(PresenceWindowTests, CombineOverlap) {
@@ -154,4 +166,16 @@ TEST(PresenceWindowTests, WhenMarkingPastLatestIndex_ShiftsTheEntireRangeToIt) {
   LOG(INFO) << "test: " << std::bitset<32>(window.present_flags());
   EXPECT_EQ(window.present_flags(), 0);
   EXPECT_EQ(window.latest(), 200);
+}
+
+TEST(PresenceWindowTests, WhenMarkingWindowSizePastLatest_OnlyOldLatestKept) {
+  PresenceWindow window{10, 0x3ff};
+
+  window.mark(42);
+  EXPECT_EQ(window.present_flags(), 0x80000000);
+  EXPECT_EQ(window.latest(), 42);
+  EXPECT_TRUE(window[10]);
+  for (u32 i = 11; i < 42; ++i) {
+    EXPECT_FALSE(window[i]) << i;
+  }
 }
\ No newline at end of file
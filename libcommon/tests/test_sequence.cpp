@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include <glue/sequence.hpp>
+
+using namespace glue;
+
+TEST(SequenceTests, GreaterThanWithoutWrap) {
+  EXPECT_TRUE(sequence_greater_than<u16>(2, 1));
+  EXPECT_FALSE(sequence_greater_than<u16>(1, 2));
+  EXPECT_FALSE(sequence_greater_than<u16>(5, 5));
+  EXPECT_TRUE(sequence_less_than<u16>(1, 2));
+}
+
+TEST(SequenceTests, GreaterThanAcrossWrap) {
+  EXPECT_TRUE(sequence_greater_than<u16>(0, 65535));
+  EXPECT_TRUE(sequence_greater_than<u16>(10, 65000));
+  EXPECT_FALSE(sequence_greater_than<u16>(65535, 0));
+  EXPECT_TRUE(sequence_less_than<u16>(65535, 3));
+  EXPECT_TRUE(sequence_greater_than<u32>(1, 0xffffffff));
+  EXPECT_TRUE(sequence_greater_than<u8>(0, 255));
+}
+
+TEST(SequenceTests, GreaterThanAtHalfRange) {
+  // exactly half the range apart can't be ordered, neither is newer
+  EXPECT_FALSE(sequence_greater_than<u16>(32768, 0));
+  EXPECT_FALSE(sequence_greater_than<u16>(0, 32768));
+  EXPECT_TRUE(sequence_greater_than<u16>(32767, 0));
+}
+
+TEST(SequenceTests, UnwrapNearReference) {
+  EXPECT_EQ(unwrap_sequence(5, 3), 5);
+  EXPECT_EQ(unwrap_sequence(1, 3), 1);
+  EXPECT_EQ(unwrap_sequence(0x0005, 0x1fffe), 0x20005);
+  EXPECT_EQ(unwrap_sequence(0xfffe, 0x20005), 0x1fffe);
+  EXPECT_EQ(unwrap_sequence(0x1234, 0x51234), 0x51234);
+}
+
+TEST(SequenceTests, UnwrapNeverGoesBelowZero) {
+  EXPECT_EQ(unwrap_sequence(0xffff, 0), 0xffff);
+  EXPECT_EQ(unwrap_sequence(0xfff0, 5), 0xfff0);
+}
+
+TEST(SequenceTests, UnwrapRoundTripsEveryIndexNearReference) {
+  for (u32 reference : {40000u, 65535u, 65536u, 1000000u}) {
+    for (u32 index = reference - 30000; index < reference + 30000; ++index) {
+      ASSERT_EQ(unwrap_sequence(static_cast<u16>(index), reference), index);
+    }
+  }
+}
@@ -33,11 +33,11 @@ struct OrbitCamera {
     return -position_rel.vector_normalized();
   }
 
-  constexpr mat4 view_matrix() const noexcept {
+  mat4 view_matrix() const noexcept {
     return glm::lookAt(position(), target, {0.0f, 1.0f, 0.0f});
   }
 
-  constexpr mat4 projection_matrix() const noexcept {
+  mat4 projection_matrix() const noexcept {
     return glm::perspective(params.fov, params.aspect, params.near_plane,
                             params.far_plane);
   }
@@ -0,0 +1,92 @@
+#include <array>
+#include <cstdio>
+#include <glue/network/compression.hpp>
+#include <glue/network/cube_state.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+
+using namespace glue;
+using namespace glue::network;
+
+/*
+ * Payload compression cost and savings, to decide when it pays off.
+ *
+ * Payloads are CubeStates packed as a snapshot message would carry them.
+ * Join payloads are cubes at rest, from further into the grid than the
+ * default dictionary covers. Live payloads are the same cubes moving and
+ * tumbling, so their quantized poses are mostly noise.
+ */
+namespace {
+std::vector<u8> packed_cubes(u32 seed, u16 count, bool moving) {
+  constexpr u16 kFirstCube = 451;
+
+  std::mt19937 rng{seed};
+  std::uniform_real_distribution<f32> jitter{-1.0f, 1.0f};
+
+  std::vector<u32> words(PayloadCompressor::kMaxPayloadBytes / 4);
+  bitpack::Packer packer{words};
+  for (u16 i = 0; i < count; ++i) {
+    auto cube = resting_cube(kFirstCube + i);
+    if (moving) {
+      cube.pose.position += vec3{jitter(rng), jitter(rng), jitter(rng)};
+      cube.pose.rotation = glm::normalize(
+          quat{1.0f, jitter(rng), jitter(rng), jitter(rng)});
+    }
+    pack(packer, cube);
+  }
+
+  const auto* bytes = reinterpret_cast<const u8*>(words.data());
+  return {bytes, bytes + (packer.current_bit() + 7) / 8};
+}
+
+void bench_payload(bench::Runner& runner, const std::string& name,
+                   const std::vector<u8>& payload, i32 level) {
+  auto compressor = PayloadCompressor::create(
+      PayloadCompressor::default_dictionary(), level);
+  if (!compressor) {
+    std::printf("%s: could not create compressor\n", name.c_str());
+    return;
+  }
+
+  std::array<u8, PayloadCompressor::kMaxPayloadBytes> compressed;
+  std::array<u8, PayloadCompressor::kMaxPayloadBytes> decompressed;
+  const auto size = compressor->compress(payload, compressed);
+
+  runner.run(name + "/compress", 1, payload.size() * 8, [&] {
+    auto result = compressor->compress(payload, compressed);
+    bench::do_not_optimize(result);
+  });
+  if (size) {
+    runner.run(name + "/decompress", 1, payload.size() * 8, [&] {
+      auto result = compressor->decompress(
+          std::span{compressed}.first(*size), decompressed);
+      bench::do_not_optimize(result);
+    });
+  }
+
+  const auto& stats = compressor->stats();
+  std::printf("%s: %zu -> %u bytes, ratio %.2f, %.2f us/compress, "
+              "%.2f us/decompress\n",
+              name.c_str(), payload.size(),
+              size ? *size : static_cast<u32>(payload.size()), stats.ratio(),
+              stats.compress_us_per_payload(),
+              stats.decompress_us_per_payload());
+}
+}  // namespace
+
+GLUE_BENCHMARK(compression) {
+  for (const i32 level : {1, PayloadCompressor::kDefaultLevel}) {
+    for (const u16 cubes : {4, 16, 40}) {
+      for (const bool moving : {false, true}) {
+        const std::string name = "compression/level" + std::to_string(level) +
+                                 "/" + std::to_string(cubes) + "cubes/" +
+                                 (moving ? "live" : "join");
+        bench_payload(runner, name,
+                      packed_cubes(runner.seed(), cubes, moving), level);
+      }
+    }
+  }
+}
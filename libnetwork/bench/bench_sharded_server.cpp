@@ -0,0 +1,112 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <glue/network/sharded_server.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+
+using namespace glue;
+using namespace glue::network;
+
+/*
+ * Server receive rate against shard count.
+ *
+ * kClients loopback sockets, spread over kSenderThreads threads, each send
+ * a burst of kBurst datagrams per call. A call ends once every shard has
+ * drained its share. Shards and senders are started once up front, so only
+ * sending and receiving is timed. Scaling needs as many cores as shards
+ * plus senders.
+ */
+namespace {
+constexpr std::size_t kClients = 32;
+constexpr std::size_t kSenderThreads = 2;
+// small enough that one shard's default receive buffer holds a whole call
+constexpr std::size_t kBurst = 4;
+constexpr std::size_t kDatagramBytes = 64;
+// a call that hasn't arrived by then lost datagrams, fail rather than
+// time the gap
+constexpr auto kArrivalTimeout = std::chrono::seconds{1};
+
+void bench_shards(bench::Runner& runner, std::size_t shard_count) {
+  const std::string name =
+      "sharded_server/" + std::to_string(shard_count) + "_shards";
+
+  std::atomic<u64> received{0};
+  auto server = ShardedServer::start(
+      0, shard_count, [&](std::size_t, Socket&, Connection&, std::span<u8>) {
+        received.fetch_add(1, std::memory_order_relaxed);
+      });
+  if (server == nullptr) {
+    std::printf("%s: could not start server\n", name.c_str());
+    return;
+  }
+  const auto address = IPv4Address::loopback(server->port());
+
+  std::vector<Socket> clients;
+  for (std::size_t i = 0; i < kClients; ++i) {
+    auto client = Socket::open_any_port();
+    if (!client) {
+      std::printf("%s: could not open clients\n", name.c_str());
+      return;
+    }
+    clients.push_back(std::move(*client));
+  }
+
+  std::vector<std::vector<u8>> payloads(kBurst,
+                                        std::vector<u8>(kDatagramBytes, 3));
+  std::vector<Datagram> burst(kBurst);
+  for (std::size_t i = 0; i < kBurst; ++i) {
+    burst[i] = {payloads[i], 0, address};
+  }
+
+  // every bump of calls makes each sender send one burst per client, 0
+  // tells them to exit
+  std::atomic<u64> calls{1};
+  std::vector<std::jthread> senders;
+  for (std::size_t t = 0; t < kSenderThreads; ++t) {
+    senders.emplace_back([&, t] {
+      for (u64 seen = 1;;) {
+        calls.wait(seen);
+        seen = calls.load();
+        if (seen == 0) {
+          return;
+        }
+        for (std::size_t c = t; c < kClients; c += kSenderThreads) {
+          clients[c].send_batch(burst);
+        }
+      }
+    });
+  }
+
+  constexpr u64 kPerCall = kClients * kBurst;
+  u64 expected = 0;
+  runner.run(name, kPerCall, [&] {
+    expected += kPerCall;
+    calls.fetch_add(1);
+    calls.notify_all();
+
+    const auto deadline = std::chrono::steady_clock::now() + kArrivalTimeout;
+    while (received.load(std::memory_order_relaxed) < expected) {
+      if (std::chrono::steady_clock::now() >= deadline) {
+        runner.fail(name + ": " +
+                    std::to_string(expected - received.load()) +
+                    " datagrams never arrived");
+        return;
+      }
+      std::this_thread::yield();
+    }
+  });
+
+  calls = 0;
+  calls.notify_all();
+}
+}  // namespace
+
+GLUE_BENCHMARK(sharded_server) {
+  for (std::size_t shards : {1, 2, 4, 8}) {
+    bench_shards(runner, shards);
+  }
+}
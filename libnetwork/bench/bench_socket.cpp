@@ -0,0 +1,156 @@
+#include <array>
+#include <glue/network/socket.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+
+using namespace glue;
+using namespace glue::network;
+
+/*
+ * Loopback packets/s for one syscall per datagram versus sendmmsg/recvmmsg,
+ * for connected sockets skipping the per-datagram address, and for GSO/GRO
+ * passing a whole run of datagrams through the stack as one.
+ *
+ * Each call sends kBurst datagrams from one socket and drains them on
+ * another, like a server tick going out to kBurst clients.
+ */
+namespace {
+constexpr std::size_t kBurst = Socket::kMaxBatchSize;
+constexpr std::size_t kMaxSpins = 1 << 16;
+
+struct Loopback {
+  Socket sender;
+  Socket receiver;
+  IPv4Address receiver_address;
+};
+
+std::optional<Loopback> open_loopback() {
+  auto sender = Socket::open_any_port();
+  auto receiver = Socket::open_any_port();
+  if (!sender || !receiver) {
+    return std::nullopt;
+  }
+  const auto address = IPv4Address::loopback(receiver->port());
+  return Loopback{std::move(*sender), std::move(*receiver), address};
+}
+
+void bench_datagram_size(bench::Runner& runner, std::size_t size) {
+  auto loopback = open_loopback();
+  if (!loopback) {
+    std::printf("socket/%zu: could not open loopback sockets\n", size);
+    return;
+  }
+  auto& [sender, receiver, address] = *loopback;
+
+  std::vector<std::vector<u8>> payloads(kBurst, std::vector<u8>(size, 7));
+  std::vector<std::array<u8, 1500>> buffers(kBurst);
+  std::vector<Datagram> outgoing(kBurst);
+  std::vector<Datagram> incoming(kBurst);
+  for (std::size_t i = 0; i < kBurst; ++i) {
+    outgoing[i] = {payloads[i], 0, address};
+    incoming[i].data = buffers[i];
+  }
+
+  const std::string name = "socket/" + std::to_string(size) + "B";
+  // loopback can still drop under pressure, so don't spin forever
+  runner.run(name + "/single", kBurst, [&] {
+    for (auto& payload : payloads) {
+      sender.send(address, payload);
+    }
+    IPv4Address from;
+    std::size_t received = 0;
+    for (std::size_t spin = 0; received < kBurst && spin < kMaxSpins;
+         ++spin) {
+      received += receiver.receive(buffers[received], from) ? 1 : 0;
+    }
+  });
+  runner.run(name + "/batch", kBurst, [&] {
+    sender.send_batch(outgoing);
+    std::size_t received = 0;
+    for (std::size_t spin = 0; received < kBurst && spin < kMaxSpins;
+         ++spin) {
+      received += receiver.receive_batch(std::span{incoming}.subspan(received));
+    }
+  });
+
+  // last, connecting changes both sockets for good
+  if (!sender.connect(address) ||
+      !receiver.connect(IPv4Address::loopback(sender.port()))) {
+    std::printf("%s: could not connect sockets\n", name.c_str());
+    return;
+  }
+  runner.run(name + "/connected", kBurst, [&] {
+    for (auto& payload : payloads) {
+      sender.send(payload);
+    }
+    std::size_t received = 0;
+    for (std::size_t spin = 0; received < kBurst && spin < kMaxSpins;
+         ++spin) {
+      received += receiver.receive(buffers[received]) ? 1 : 0;
+    }
+  });
+}
+
+/*
+ * One server tick of state for one client, split into MTU-sized datagrams.
+ * The batch run is the baseline, same datagrams through sendmmsg/recvmmsg.
+ */
+void bench_segments(bench::Runner& runner) {
+  constexpr u16 kSegmentSize = 1200;
+  constexpr std::size_t kSegments = Socket::kMaxSegmentedBytes / kSegmentSize;
+
+  auto loopback = open_loopback();
+  if (!loopback) {
+    std::printf("socket/segments: could not open loopback sockets\n");
+    return;
+  }
+  auto& [sender, receiver, address] = *loopback;
+  if (!sender.enable_gso() || !receiver.enable_gro()) {
+    std::printf("socket/segments: GSO/GRO unsupported, skipping\n");
+    return;
+  }
+
+  std::vector<u8> payload(kSegments * kSegmentSize, 7);
+  std::vector<u8> buffer(Socket::kMaxSegmentedBytes);
+
+  std::vector<std::array<u8, 1500>> buffers(kSegments);
+  std::vector<Datagram> outgoing(kSegments);
+  std::vector<Datagram> incoming(kSegments);
+  for (std::size_t i = 0; i < kSegments; ++i) {
+    outgoing[i] = {std::span{payload}.subspan(i * kSegmentSize, kSegmentSize),
+                   0, address};
+    incoming[i].data = buffers[i];
+  }
+
+  const std::string name = "socket/" + std::to_string(kSegmentSize) + "Bx" +
+                           std::to_string(kSegments);
+  runner.run(name + "/batch", kSegments, [&] {
+    sender.send_batch(outgoing);
+    std::size_t received = 0;
+    for (std::size_t spin = 0; received < kSegments && spin < kMaxSpins;
+         ++spin) {
+      received += receiver.receive_batch(std::span{incoming}.subspan(received));
+    }
+  });
+  runner.run(name + "/segments", kSegments, [&] {
+    sender.send_segments(address, payload, kSegmentSize);
+    IPv4Address from;
+    u16 segment_size = 0;
+    std::size_t received = 0;
+    for (std::size_t spin = 0; received < payload.size() && spin < kMaxSpins;
+         ++spin) {
+      received += receiver.receive_segments(buffer, from, segment_size)
+                      .value_or(0);
+    }
+  });
+}
+}  // namespace
+
+GLUE_BENCHMARK(socket) {
+  bench_datagram_size(runner, 64);
+  bench_datagram_size(runner, 1200);
+  bench_segments(runner);
+}
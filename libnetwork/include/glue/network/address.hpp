@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <glue/types.hpp>
 
 namespace glue::network {
@@ -35,4 +36,13 @@ class IPv4Address final {
   u32 ip_;
   u16 port_;
 };
-}  // namespace glue::network
\ No newline at end of file
+}  // namespace glue::network
+
+template <>
+struct std::hash<glue::network::IPv4Address> {
+  std::size_t operator()(
+      const glue::network::IPv4Address& address) const noexcept {
+    const glue::u64 key = (glue::u64{address.ip()} << 16) | address.port();
+    return std::hash<glue::u64>{}(key);
+  }
+};
\ No newline at end of file
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <glue/bitpack/bitpack.hpp>
+#include <glue/types.hpp>
+#include <memory>
+#include <optional>
+#include <span>
+
+namespace glue::network {
+/*
+ * How well a PayloadCompressor is doing, to decide whether it pays off.
+ */
+struct CompressionStats {
+  // payloads big enough to try compressing, and how many got smaller
+  u64 attempted = 0;
+  u64 compressed = 0;
+
+  // bytes of attempted payloads, and what was sent for them
+  u64 bytes_in = 0;
+  u64 bytes_out = 0;
+
+  u64 decompressed = 0;
+
+  f64 compress_sec = 0.0;
+  f64 decompress_sec = 0.0;
+
+  /*
+   * Sent bytes over payload bytes, below 1 is a saving.
+   */
+  f64 ratio() const noexcept {
+    return bytes_in == 0 ? 1.0 : static_cast<f64>(bytes_out) / bytes_in;
+  }
+
+  f64 compress_us_per_payload() const noexcept {
+    return attempted == 0 ? 0.0 : compress_sec * 1e6 / attempted;
+  }
+
+  f64 decompress_us_per_payload() const noexcept {
+    return decompressed == 0 ? 0.0 : decompress_sec * 1e6 / decompressed;
+  }
+};
+
+/*
+ * Optional deflate stage for message payloads, mainly reliable and
+ * bulk/join messages big enough for it to pay off.
+ *
+ * Payloads of at least kMinCompressBytes are deflated against a preset
+ * dictionary of typical message bytes, and sent compressed only if that
+ * came out smaller. A flag bit tells read() which it got. Raw deflate, so
+ * there's no zlib header or checksum per payload.
+ *
+ * Keep one per connection. The zlib streams and buffers are allocated once
+ * in create() and reset per payload, so nothing allocates per packet.
+ *
+ * Wire format, written by write() and read by read():
+ *   compressed : 1 bit
+ *   size       : 11 bits
+ *   bytes      : size * 8 bits
+ */
+class PayloadCompressor final {
+ public:
+  static constexpr u32 kMaxPayloadBytes = 1200;
+  static constexpr u32 kMinCompressBytes = 64;
+  static constexpr u32 kSizeBits = 11;
+
+  // zlib's default, 1 is faster and 9 smaller
+  static constexpr i32 kDefaultLevel = 6;
+
+  static_assert(kMaxPayloadBytes < (1u << kSizeBits));
+
+  PayloadCompressor(const PayloadCompressor&) = delete;
+  PayloadCompressor& operator=(const PayloadCompressor&) = delete;
+
+  PayloadCompressor(PayloadCompressor&&) noexcept;
+  PayloadCompressor& operator=(PayloadCompressor&&) noexcept;
+
+  ~PayloadCompressor();
+
+  /*
+   * dictionary is copied, and both sides must use the same one.
+   */
+  static std::optional<PayloadCompressor> create(
+      std::span<const u8> dictionary = default_dictionary(),
+      i32 level = kDefaultLevel);
+
+  /*
+   * Bytes that show up in our messages: CubeStates at rest as packed for
+   * join snapshots.
+   */
+  static std::span<const u8> default_dictionary();
+
+  /*
+   * Deflates payload into out. Returns the compressed size, or nullopt if
+   * it wouldn't be smaller than payload or doesn't fit in out.
+   */
+  std::optional<u32> compress(std::span<const u8> payload, std::span<u8> out);
+
+  /*
+   * Inflates compressed into out. Returns the payload size, or nullopt if
+   * the data is corrupt or doesn't fit in out.
+   */
+  std::optional<u32> decompress(std::span<const u8> compressed,
+                                std::span<u8> out);
+
+  template <bitpack::CWritePacker T>
+  void write(T& packer, std::span<const u8> payload) {
+    glue_assert(payload.size() <= kMaxPayloadBytes);
+
+    auto bytes = payload;
+    bool compressed = false;
+    if (payload.size() >= kMinCompressBytes) {
+      const auto out = write_buffer();
+      if (const auto size = compress(payload, out)) {
+        bytes = out.first(*size);
+        compressed = true;
+      }
+    }
+
+    bitpack::pack(packer, compressed);
+    u32 size = static_cast<u32>(bytes.size());
+    bitpack::pack_bits(packer, size, 0, kSizeBits);
+    bitpack::pack_bits(packer, bytes, 0, 8);
+  }
+
+  /*
+   * The payload written by write(), valid until the next read().
+   *
+   * Returns nullopt if the data is malformed, the packet should be dropped.
+   */
+  template <bitpack::CReadPacker T>
+  std::optional<std::span<const u8>> read(T& unpacker) {
+    bool compressed = false;
+    bitpack::pack(unpacker, compressed);
+    u32 size = 0;
+    bitpack::pack_bits(unpacker, size, 0, kSizeBits);
+    if (size > kMaxPayloadBytes) {
+      return std::nullopt;
+    }
+
+    const auto bytes = read_buffer().first(size);
+    bitpack::pack_bits(unpacker, bytes, 0, 8);
+    if (!compressed) {
+      return bytes;
+    }
+
+    const auto out = payload_buffer();
+    const auto payload_size = decompress(bytes, out);
+    if (!payload_size) {
+      return std::nullopt;
+    }
+    return out.first(*payload_size);
+  }
+
+  const CompressionStats& stats() const noexcept { return stats_; }
+
+ private:
+  struct State;
+
+  explicit PayloadCompressor(std::unique_ptr<State> state) noexcept;
+
+  std::span<u8> write_buffer() noexcept;
+  std::span<u8> read_buffer() noexcept;
+  std::span<u8> payload_buffer() noexcept;
+
+ private:
+  // zlib streams point back at themselves, so they can't move
+  std::unique_ptr<State> state_;
+  CompressionStats stats_;
+};
+}  // namespace glue::network
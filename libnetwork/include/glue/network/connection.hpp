@@ -1,19 +1,155 @@
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <glue/network/address.hpp>
+#include <glue/network/packet.hpp>
+#include <glue/network/telemetry.hpp>
+#include <glue/presence_window.hpp>
+#include <glue/types.hpp>
+
 namespace glue::network {
 struct IConnection {
   virtual ~IConnection() = default;
 };
 
+/*
+ * Told the fate of every packet a Connection sends, e.g. to resend what it
+ * carried.
+ */
+struct IPacketListener {
+  virtual ~IPacketListener() = default;
+  virtual void on_packet_acked(u32 index) = 0;
+  virtual void on_packet_lost(u32 index) = 0;
+};
+
 /*
  * A UDP connection with another party.
  *
  * Sends packets to the destination IP and receives packets filtered by same IP.
+ * A client's Socket::connect() has the kernel do that filtering.
+ *
+ * Implements a lightweight packet receipt tracker:
+ *  - next_header() gives every outgoing packet the next index, starting at 1,
+ *    and acks the last 33 received packets from a PresenceWindow.
+ *  - on_receive() reads the other side's acks. Send times are kept in a ring,
+ *    so acked packets give RTT samples.
+ *  - A sent packet is lost once it leaves the other side's ack window, or its
+ *    ring slot is reused, without being acked.
  *
- * Implements a lightweight packet receipt tracker.
+ * Times are passed in, so the tracker can be driven by a simulated clock.
  */
 class Connection final {
  public:
+  using Clock = std::chrono::steady_clock;
+
+  // must be larger than the 33 packet ack window
+  static constexpr u32 kSentRingSize = 256;
+
+  // RFC 6298 smoothing factors
+  static constexpr f64 kRttGain = 1.0 / 8.0;
+  static constexpr f64 kJitterGain = 1.0 / 4.0;
+  static constexpr f64 kLossGain = 1.0 / 32.0;
+
+  Connection() noexcept = default;
+  explicit Connection(const IPv4Address& address) noexcept
+      : address_{address} {}
+
+  /*
+   * Header for the next outgoing packet. Records its send time.
+   */
+  PacketHeader next_header(Clock::time_point now) noexcept;
+
+  /*
+   * Marks header.index received and processes its acks.
+   *
+   * Only the low 16 bits of the indices are used, as they come off the
+   * wire. index is unwrapped around the newest received packet and
+   * receipt_index as a step back from the newest sent one, so both keep
+   * counting up past 65535. A receipt_index ahead of the newest sent packet
+   * is bogus, the packet is still received but its acks are ignored.
+   *
+   * Returns false for duplicates and packets too old to track, which should
+   * be dropped.
+   */
+  bool on_receive(const PacketHeader& header, Clock::time_point now) noexcept;
+
+  /*
+   * Not owned, nullptr to stop listening.
+   */
+  constexpr void set_listener(IPacketListener* listener) noexcept {
+    listener_ = listener;
+  }
+
+  /*
+   * Not owned, nullptr to stop recording. Snapshots can be read from any
+   * thread while this one records.
+   */
+  constexpr void set_telemetry(ConnectionTelemetry* telemetry) noexcept {
+    telemetry_ = telemetry;
+  }
+
+  constexpr const IPv4Address& address() const noexcept { return address_; }
+
+  /*
+   * Smoothed round trip time in seconds, 0 until the first ack.
+   */
+  constexpr f64 rtt() const noexcept { return rtt_; }
+
+  /*
+   * Smoothed mean deviation of the round trip time in seconds.
+   */
+  constexpr f64 jitter() const noexcept { return jitter_; }
+
+  /*
+   * Smoothed fraction of sent packets that were lost, 0 to 1.
+   */
+  constexpr f64 packet_loss() const noexcept { return packet_loss_; }
+
+  constexpr u64 sent_count() const noexcept { return sent_count_; }
+  constexpr u64 acked_count() const noexcept { return acked_count_; }
+  constexpr u64 lost_count() const noexcept { return lost_count_; }
+
+  constexpr const PresenceWindow& received() const noexcept {
+    return received_;
+  }
+
+ private:
+  struct SentPacket {
+    u32 index = 0;
+    bool acked = false;
+    Clock::time_point sent_at;
+  };
+
+  constexpr SentPacket& sent(u32 index) noexcept {
+    return sent_[index % kSentRingSize];
+  }
+
+  void add_rtt_sample(f64 sample) noexcept;
+
+  /*
+   * Settles every sent packet before boundary, counting the unacked ones as
+   * lost.
+   */
+  void resolve_until(u32 boundary) noexcept;
+
  private:
+  IPv4Address address_;
+  IPacketListener* listener_ = nullptr;
+  ConnectionTelemetry* telemetry_ = nullptr;
+
+  u32 next_index_ = 1;
+  u32 resolved_until_ = 1;
+  std::array<SentPacket, kSentRingSize> sent_{};
+
+  PresenceWindow received_;
+
+  f64 rtt_ = 0.0;
+  f64 jitter_ = 0.0;
+  f64 packet_loss_ = 0.0;
+
+  u64 sent_count_ = 0;
+  u64 acked_count_ = 0;
+  u64 lost_count_ = 0;
 };
-}  // namespace glue::network
\ No newline at end of file
+}  // namespace glue::network
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <glue/bitpack/bitpack.hpp>
+#include <glue/bitpack/pack_pose.hpp>
+#include <glue/types.hpp>
+
+namespace glue::network {
+/*
+ * One cube of a world state or join snapshot: its index in
+ * WorldFrame::cubes and its pose.
+ */
+struct CubeState final {
+  u16 index;
+  Pose pose;
+};
+
+// the default world fits in a 128m box, 16 bits is 2mm steps across it
+using CubePoseQuantize = bitpack::QuantizePose<16, 9>;
+inline const CubePoseQuantize kCubePoseQuantize{vec3{-64.0f}, vec3{64.0f}};
+
+template <bitpack::CPacker T>
+inline constexpr void pack(T& packer, CubeState& cube) {
+  pack(packer, cube.index);
+  pack(packer, cube.pose, kCubePoseQuantize);
+}
+
+/*
+ * Where cube index rests in the default world, the grid WorldFrame::init()
+ * lays out for 30 by 30 cubes 0.2 wide. Index 0 is the player.
+ */
+inline CubeState resting_cube(u16 index) noexcept {
+  constexpr u32 kGridWidth = 30;
+  constexpr f32 kCubeWidth = 0.2f;
+  constexpr f32 kSpacing = 6.0f * kCubeWidth;
+  constexpr f32 kStart = -0.5f * kSpacing * kGridWidth;
+
+  const u32 cell = index == 0 ? 0 : index - 1u;
+  const vec3 position{kStart + kSpacing * static_cast<f32>(cell / kGridWidth),
+                      kCubeWidth,
+                      kStart + kSpacing * static_cast<f32>(cell % kGridWidth)};
+  return {index, Pose{position, glm::identity<quat>()}};
+}
+}  // namespace glue::network
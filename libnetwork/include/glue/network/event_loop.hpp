@@ -0,0 +1,168 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <functional>
+#include <glue/network/address.hpp>
+#include <glue/network/connection.hpp>
+#include <glue/network/socket.hpp>
+#include <glue/types.hpp>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace glue::network {
+/*
+ * Blocks in epoll until a socket is readable, a timer fires or stop() is
+ * called, instead of spin-polling Socket::receive.
+ *
+ * Readable sockets get one receive_batch() per wakeup, so a flooded socket
+ * can't hold up timers or stop(). Every datagram is handed to its socket's
+ * callback along with the Connection for its sender, created on first
+ * contact. The loop doesn't parse datagrams, the callback must pass packet
+ * headers to Connection::on_receive() itself.
+ *
+ * Anyone can send from any address, so connections are capped and dropped
+ * once idle, see set_connection_limits(). Datagrams from new senders while
+ * at the cap are dropped.
+ *
+ * Everything but stop() must be called from the thread running the loop.
+ *
+ * WINDOWS: Linux only, would need IOCP or select()
+ */
+class EventLoop final {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using OnDatagramCallback = void(Connection&, std::span<u8>);
+  using OnTimerCallback = void();
+
+  static constexpr std::size_t kMaxDatagramBytes = 1500;
+  static constexpr std::size_t kMaxEvents = 64;
+
+  static constexpr std::size_t kDefaultMaxConnections = 1024;
+  static constexpr Clock::duration kDefaultIdleTimeout =
+      std::chrono::seconds{10};
+
+  EventLoop(const EventLoop&) = delete;
+  EventLoop& operator=(const EventLoop&) = delete;
+
+  EventLoop(EventLoop&& other) noexcept { swap(*this, other); }
+  EventLoop& operator=(EventLoop&& other) noexcept {
+    swap(*this, other);
+    return *this;
+  }
+
+  ~EventLoop();
+
+  static std::optional<EventLoop> create();
+
+  /*
+   * socket isn't owned and must outlive the loop.
+   */
+  bool add_socket(Socket& socket,
+                  std::function<OnDatagramCallback> on_datagram);
+
+  /*
+   * Calls on_timer every interval, starting one interval from now. Missed
+   * intervals are coalesced into one call.
+   */
+  bool add_timer(Clock::duration interval,
+                 std::function<OnTimerCallback> on_timer);
+
+  /*
+   * Dispatches events until stop().
+   */
+  void run();
+
+  /*
+   * Waits up to timeout for events and dispatches them. Timeouts too long
+   * for epoll wait forever. Returns false once stopped.
+   */
+  bool run_once(Clock::duration timeout);
+
+  /*
+   * Wakes the loop and makes run() return. Safe from any thread and from
+   * callbacks.
+   */
+  void stop() noexcept;
+
+  bool stopped() const noexcept { return stopped_; }
+
+  /*
+   * At most max_connections at once. A Connection is dropped once nothing
+   * was received from its address for idle_timeout, checked at least every
+   * idle_timeout / 2 while the loop is woken up.
+   */
+  void set_connection_limits(std::size_t max_connections,
+                             Clock::duration idle_timeout) noexcept;
+
+  /*
+   * Valid until the loop next runs, the connection may expire.
+   */
+  Connection* find_connection(const IPv4Address& address) noexcept;
+  std::size_t connection_count() const noexcept { return connections_.size(); }
+
+  /*
+   * Datagrams dropped because their sender was new and the loop was at
+   * max_connections.
+   */
+  u64 refused_count() const noexcept { return refused_count_; }
+
+  friend void swap(EventLoop& a, EventLoop& b) noexcept {
+    using std::swap;
+    swap(a.epoll_, b.epoll_);
+    swap(a.stop_event_, b.stop_event_);
+    swap(a.stopped_, b.stopped_);
+    swap(a.sources_, b.sources_);
+    swap(a.buffers_, b.buffers_);
+    swap(a.datagrams_, b.datagrams_);
+    swap(a.connections_, b.connections_);
+    swap(a.max_connections_, b.max_connections_);
+    swap(a.idle_timeout_, b.idle_timeout_);
+    swap(a.next_expiry_, b.next_expiry_);
+    swap(a.refused_count_, b.refused_count_);
+  }
+
+ private:
+  EventLoop() = default;
+
+  struct TrackedConnection {
+    Connection connection;
+    Clock::time_point last_received;
+  };
+
+  struct Source {
+    i32 fd;
+    Socket* socket;  // nullptr for timers
+    std::function<OnDatagramCallback> on_datagram;
+    std::function<OnTimerCallback> on_timer;
+  };
+
+  void drain(Source& source);
+  void fire(Source& source);
+
+  /*
+   * Nullptr if address is new and there's no room for it.
+   */
+  Connection* connection_for(const IPv4Address& address,
+                             Clock::time_point now);
+  void expire_idle(Clock::time_point now);
+
+ private:
+  i32 epoll_ = -1;
+  i32 stop_event_ = -1;
+  bool stopped_ = false;
+
+  std::vector<Source> sources_;
+
+  std::vector<std::array<u8, kMaxDatagramBytes>> buffers_;
+  std::vector<Datagram> datagrams_;
+
+  std::unordered_map<IPv4Address, TrackedConnection> connections_;
+  std::size_t max_connections_ = kDefaultMaxConnections;
+  Clock::duration idle_timeout_ = kDefaultIdleTimeout;
+  Clock::time_point next_expiry_{};
+  u64 refused_count_ = 0;
+};
+}  // namespace glue::network
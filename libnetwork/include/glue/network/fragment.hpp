@@ -0,0 +1,160 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <glue/bitpack/bitpack.hpp>
+#include <glue/network/packet.hpp>
+#include <glue/types.hpp>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace glue::network {
+/*
+ * Large payloads, e.g. a full WorldFrame for initial sync, are bitpacked
+ * into a buffer of u32 words and sent as a group of fragments, each small
+ * enough for one datagram. A fragment is a FragmentHeader followed by up
+ * to kFragmentWords payload words.
+ *
+ * Every fragment but the last carries exactly kFragmentWords words, so
+ * index alone places a fragment in the payload.
+ */
+struct FragmentHeader final {
+  u16 group;  // which payload, wraps
+  u16 index;
+  u16 count;
+  u16 words;  // payload words in this fragment
+};
+
+template <bitpack::CPacker T>
+inline constexpr void pack(T& packer, FragmentHeader& header) {
+  pack(packer, header.group);
+  pack(packer, header.index);
+  pack(packer, header.count);
+  pack(packer, header.words);
+}
+
+// packet data stays under a 1200 byte datagram with room to spare
+inline constexpr u32 kFragmentWords = 280;
+inline constexpr u32 kMaxFragments = 0xffff;
+
+inline constexpr u32 fragment_count(std::size_t payload_words) noexcept {
+  return static_cast<u32>((payload_words + kFragmentWords - 1) /
+                          kFragmentWords);
+}
+
+/*
+ * Packet data size for fragments, see Packet::data_size_bytes().
+ */
+inline constexpr u32 kFragmentDataSizeBytes =
+    Packet::data_size_bytes([](auto& packer) {
+      FragmentHeader header{};
+      pack(packer, header);
+      for (u32 i = 0; i < kFragmentWords; ++i) {
+        packer.write_bits(0, 32);
+      }
+    });
+
+/*
+ * Writes fragment index of payload, split into fragment_count() fragments.
+ */
+template <bitpack::CWritePacker T>
+inline void write_fragment(T& packer, u16 group, std::span<const u32> payload,
+                           u32 index) {
+  const u32 count = fragment_count(payload.size());
+  glue_assert(count <= kMaxFragments);
+  glue_assert(index < count);
+
+  const auto words = payload.subspan(index * kFragmentWords)
+                         .first(std::min<std::size_t>(
+                             kFragmentWords,
+                             payload.size() - index * kFragmentWords));
+  FragmentHeader header{group, static_cast<u16>(index),
+                        static_cast<u16>(count),
+                        static_cast<u16>(words.size())};
+  pack(packer, header);
+  bitpack::pack_bits(packer, words, 0u, 32);
+}
+
+/*
+ * Collects the fragments of one group at a time into a buffer allocated
+ * up front, one per connection.
+ *
+ * Fragments may arrive in any order and more than once. A fragment of a
+ * newer group drops the group being collected, as does no fragment
+ * arriving for timeout.
+ */
+class Reassembler final {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  Reassembler(std::size_t max_payload_words, Clock::duration timeout);
+
+  /*
+   * Reads a fragment written by write_fragment(). Malformed fragments and
+   * fragments of old or completed groups are ignored.
+   *
+   * Returns the whole payload once its last missing fragment is read. The
+   * span is valid until the next read().
+   */
+  template <bitpack::CReadPacker T>
+  std::optional<std::span<const u32>> read(T& unpacker, Clock::time_point now) {
+    FragmentHeader header{};
+    pack(unpacker, header);
+
+    if (header.words > kFragmentWords) {
+      return std::nullopt;
+    }
+
+    u32* destination = begin_fragment(header, now);
+    if (destination == nullptr) {
+      // still have to get past its words
+      for (u16 i = 0; i < header.words; ++i) {
+        unpacker.read_bits(32);
+      }
+      return std::nullopt;
+    }
+
+    bitpack::pack_bits(unpacker, std::span{destination, header.words}, 0u, 32);
+    return end_fragment(header);
+  }
+
+  /*
+   * Drops the group being collected if it timed out.
+   */
+  void update(Clock::time_point now) noexcept;
+
+  bool collecting() const noexcept { return collecting_; }
+  u16 group() const noexcept { return group_; }
+  u32 received_count() const noexcept { return received_count_; }
+
+  std::size_t max_payload_words() const noexcept { return buffer_.size(); }
+
+ private:
+  /*
+   * Where header's words go, nullptr if the fragment should be skipped.
+   */
+  u32* begin_fragment(const FragmentHeader& header,
+                      Clock::time_point now) noexcept;
+
+  std::optional<std::span<const u32>> end_fragment(
+      const FragmentHeader& header) noexcept;
+
+  void start_group(const FragmentHeader& header,
+                   Clock::time_point now) noexcept;
+
+ private:
+  Clock::duration timeout_;
+
+  std::vector<u32> buffer_;
+  std::vector<bool> received_;
+
+  bool collecting_ = false;
+  bool completed_ = false;
+  u16 group_ = 0;
+  u16 count_ = 0;
+  u32 received_count_ = 0;
+  std::size_t payload_words_ = 0;
+  Clock::time_point last_fragment_at_;
+};
+}  // namespace glue::network
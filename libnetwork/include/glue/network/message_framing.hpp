@@ -0,0 +1,48 @@
+#pragma once
+
+#include <glue/bitpack/bitpack.hpp>
+#include <glue/types.hpp>
+
+namespace glue::network {
+/*
+ * The message lists ReliableChannel and SendScheduler pack into packets,
+ * defined once so the two can't drift apart:
+ *   count : kCountBits
+ *   count times:
+ *     (ReliableChannel only) id : 16 bits
+ *     size  : kSizeBits
+ *     bytes : size * 8 bits
+ *
+ * pack_count() and pack_size() go both ways like pack(). Unpacking, they
+ * return false for values out of range, the packet should be dropped.
+ */
+struct MessageFraming {
+  static constexpr u32 kMaxMessageBytes = 256;
+  static constexpr u32 kMaxMessagesPerPacket = 16;
+
+  static constexpr u32 kCountBits = 5;
+  static constexpr u32 kSizeBits = 9;
+
+  static_assert(kMaxMessagesPerPacket < (1u << kCountBits));
+  static_assert(kMaxMessageBytes < (1u << kSizeBits));
+
+  /*
+   * Bits for a message's size and bytes, without the count or an id.
+   */
+  static constexpr std::size_t body_bits(u32 size) noexcept {
+    return kSizeBits + size * 8;
+  }
+
+  template <bitpack::CPacker T>
+  static constexpr bool pack_count(T& packer, u32& count) {
+    bitpack::pack_bits(packer, count, 0, kCountBits);
+    return count <= kMaxMessagesPerPacket;
+  }
+
+  template <bitpack::CPacker T>
+  static constexpr bool pack_size(T& packer, u32& size) {
+    bitpack::pack_bits(packer, size, 0, kSizeBits);
+    return size <= kMaxMessageBytes;
+  }
+};
+}  // namespace glue::network
@@ -9,8 +9,14 @@
 #include <type_traits>
 
 namespace glue::network {
+/*
+ * Indices are full u32s in memory but only their low kSequenceBits go on the
+ * wire, 64 bits per header instead of 96. An unpacked header holds the
+ * wrapped values until Connection::on_receive() unwraps them.
+ */
 struct PacketHeader final {
-  // drop indices to less bits.
+  static constexpr u32 kSequenceBits = 16;
+
   u32 index;
   u32 receipt_index;
   u32 receipt_flags;
@@ -18,8 +24,10 @@ struct PacketHeader final {
 
 template <bitpack::CPacker T>
 inline constexpr void pack(T& packer, PacketHeader& header) {
-  pack(packer, header.index);
-  pack(packer, header.receipt_index);
+  bitpack::pack_bits_wrap(packer, header.index, 0u,
+                          PacketHeader::kSequenceBits);
+  bitpack::pack_bits_wrap(packer, header.receipt_index, 0u,
+                          PacketHeader::kSequenceBits);
   pack(packer, header.receipt_flags);
 }
 
@@ -58,6 +66,24 @@ class Packet final {
     return aligned_size;
   }
 
+  /*
+   * Data size needed for the header plus whatever pack_fn packs, rounded up
+   * to whole u32 words. Pass it to alloc_size_bytes() and unsafe_init().
+   *
+   * constexpr when pack_fn is, so fixed-size messages can size their
+   * packets at compile time.
+   */
+  template <std::invocable<bitpack::Measurer&> Fn>
+  static constexpr u32 data_size_bytes(Fn pack_fn) {
+    const std::size_t bits = bitpack::measure_bits([&](auto& measurer) {
+      PacketHeader header{};
+      network::pack(measurer, header);
+      pack_fn(measurer);
+    });
+    const std::size_t words = (bits + 31) / 32;
+    return static_cast<u32>(words * sizeof(u32));
+  }
+
   static Packet* unsafe_init(u8* start, u32 size, const PacketHeader& header) {
     glue_assert(ptr_is_aligned(start, kAlignment));
     return new (start) Packet{size, header};
@@ -77,6 +103,39 @@ class Packet final {
     pack_fn(unpacker);
   }
 
+  /*
+   * unpack() for packets straight off the wire.
+   *
+   * Returns false if the header or pack_fn read past the end of the packet,
+   * in which case whatever was unpacked should be dropped.
+   */
+  template <std::invocable<bitpack::CheckedUnpacker&> Fn>
+  constexpr bool unpack_checked(Fn pack_fn) {
+    bitpack::CheckedUnpacker unpacker{as_u32_span()};
+    network::pack(unpacker, header_);
+    pack_fn(unpacker);
+    return !unpacker.overflowed();
+  }
+
+  /*
+   * For datagrams received straight into data(), e.g. through as_span().
+   *
+   * Shrinks the packet to the received_bytes actually received and unpacks
+   * the header in place. Returns false if the datagram can't be a packet:
+   * not whole u32 words, or too short for the header.
+   */
+  bool finish_receive(u32 received_bytes) {
+    glue_assert(received_bytes <= size_bytes_);
+    if (received_bytes % sizeof(u32) != 0) {
+      return false;
+    }
+    size_bytes_ = received_bytes;
+
+    bitpack::CheckedUnpacker unpacker{as_u32_span()};
+    network::pack(unpacker, header_);
+    return !unpacker.overflowed();
+  }
+
   constexpr std::span<u8> as_span() { return {begin(), end()}; }
 
   std::span<u32> as_u32_span() {
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <glue/network/packet.hpp>
+#include <glue/types.hpp>
+#include <memory>
+
+namespace glue::network {
+/*
+ * Fixed number of Packet slots of one size, carved out of a single slab.
+ *
+ * acquire() and release() never allocate and are lock-free, so packets can
+ * be handed between the receive, simulation and send threads. Any thread
+ * may release a packet acquired on another.
+ *
+ * The free list is a stack of slot indices. Its head carries a tag that
+ * changes on every push and pop so a stale compare-exchange can't succeed
+ * (ABA).
+ */
+class PacketPool final {
+ public:
+  PacketPool(u32 packet_size, u32 capacity);
+
+  PacketPool(const PacketPool&) = delete;
+  PacketPool& operator=(const PacketPool&) = delete;
+  PacketPool(PacketPool&&) = delete;
+  PacketPool& operator=(PacketPool&&) = delete;
+
+  /*
+   * A packet of packet_size() data bytes, or nullptr if all are in use.
+   */
+  Packet* acquire(const PacketHeader& header = {}) noexcept;
+
+  /*
+   * Returns a packet from acquire() to the pool.
+   */
+  void release(Packet* packet) noexcept;
+
+  bool owns(const Packet* packet) const noexcept;
+
+  u32 packet_size() const noexcept { return packet_size_; }
+  u32 capacity() const noexcept { return capacity_; }
+  std::size_t slot_size_bytes() const noexcept { return slot_size_; }
+
+ private:
+  static constexpr u32 kEnd = ~u32{0};
+
+  static constexpr u64 make_head(u32 tag, u32 index) noexcept {
+    return (static_cast<u64>(tag) << 32) | index;
+  }
+  static constexpr u32 head_tag(u64 head) noexcept {
+    return static_cast<u32>(head >> 32);
+  }
+  static constexpr u32 head_index(u64 head) noexcept {
+    return static_cast<u32>(head);
+  }
+
+  u8* slot(u32 index) const noexcept {
+    return slab_.get() + index * slot_size_;
+  }
+
+ private:
+  u32 packet_size_;
+  u32 capacity_;
+  std::size_t slot_size_;
+
+  std::unique_ptr<u8[]> slab_;
+  std::unique_ptr<std::atomic<u32>[]> next_;
+  std::atomic<u64> head_;
+};
+}  // namespace glue::network
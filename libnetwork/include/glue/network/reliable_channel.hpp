@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <glue/bitpack/bitpack.hpp>
+#include <glue/collections/fixed_vec.hpp>
+#include <glue/network/connection.hpp>
+#include <glue/network/message_framing.hpp>
+#include <glue/types.hpp>
+#include <span>
+
+namespace glue::network {
+/*
+ * Reliable, ordered messages riding along in the packets of a Connection.
+ *
+ * write() packs pending messages into a packet before its unreliable data,
+ * read() unpacks them on the other side. Nothing is acked separately: the
+ * channel listens to the Connection and resends a message only once the
+ * packet carrying it is lost. A lost message holds back the ones after it,
+ * but not the unreliable data sharing their packets.
+ *
+ * Wire format, written by write() and read by read(), see MessageFraming:
+ *   count : 5 bits
+ *   count times:
+ *     id    : 16 bits
+ *     size  : 9 bits
+ *     bytes : size * 8 bits
+ *
+ * Usage, with channel set as connection's listener:
+ *   send:    header = connection.next_header(now)
+ *            pack header, channel.write(packer, header.index, bits), data
+ *   receive: unpack header, channel.read(unpacker, on_message), data
+ *            connection.on_receive(header, now)
+ */
+class ReliableChannel final : public IPacketListener {
+ public:
+  static constexpr u32 kMaxMessageBytes = MessageFraming::kMaxMessageBytes;
+  static constexpr u32 kMaxMessagesPerPacket =
+      MessageFraming::kMaxMessagesPerPacket;
+
+  // messages sent but not yet acked
+  static constexpr u16 kMessageWindow = 64;
+
+  static constexpr u32 kCountBits = MessageFraming::kCountBits;
+  static constexpr u32 kIdBits = 16;
+
+  /*
+   * Queues a message, returns false if kMessageWindow messages are still
+   * unacked.
+   */
+  bool send(std::span<const u8> message) noexcept;
+
+  /*
+   * Packs as many waiting messages as fit in max_bits, oldest first, and
+   * remembers they went out in packet_index.
+   *
+   * Always writes at least kCountBits.
+   */
+  template <bitpack::CWritePacker T>
+  void write(T& packer, u32 packet_index, std::size_t max_bits) {
+    glue_assert(max_bits >= kCountBits);
+
+    auto& record = sent_[packet_index % Connection::kSentRingSize];
+    record.index = packet_index;
+    record.ids.clear();
+
+    std::size_t bits = kCountBits;
+    for (u16 id = oldest_unacked_; id != next_id_ && !record.ids.full();
+         ++id) {
+      const auto& message = outgoing(id);
+      if (message.acked || message.in_flight) {
+        continue;
+      }
+      bits += message_bits(message.size);
+      if (bits > max_bits) {
+        break;
+      }
+      record.ids.push_back(id);
+    }
+
+    u32 count = static_cast<u32>(record.ids.size());
+    MessageFraming::pack_count(packer, count);
+    for (u16 id : record.ids) {
+      auto& message = outgoing(id);
+      message.in_flight = true;
+
+      u32 size = message.size;
+      bitpack::pack(packer, id);
+      MessageFraming::pack_size(packer, size);
+      bitpack::pack_bits(packer, std::span{message.data}.first(size), 0, 8);
+    }
+  }
+
+  /*
+   * Unpacks the messages written by write() and calls on_message with every
+   * message that's next in order, including ones held back until now.
+   *
+   * Returns false if the data is malformed or, for a CheckedUnpacker,
+   * truncated. The packet should be dropped, and none of its messages are
+   * kept.
+   */
+  template <bitpack::CReadPacker T,
+            std::invocable<std::span<const u8>> OnMessage>
+  bool read(T& unpacker, OnMessage&& on_message) {
+    u32 count = 0;
+    if (!MessageFraming::pack_count(unpacker, count)) {
+      return false;
+    }
+
+    // parse the whole packet before keeping any of it
+    parsed_.clear();
+    for (u32 i = 0; i < count; ++i) {
+      parsed_.emplace_back();
+      auto& parsed = parsed_[i];
+      u32 size = 0;
+      bitpack::pack(unpacker, parsed.id);
+      if (!MessageFraming::pack_size(unpacker, size)) {
+        return false;
+      }
+      parsed.size = static_cast<u16>(size);
+      bitpack::pack_bits(unpacker, std::span{parsed.data}.first(size), 0, 8);
+    }
+    if constexpr (requires { unpacker.overflowed(); }) {
+      if (unpacker.overflowed()) {
+        return false;
+      }
+    }
+
+    for (const auto& parsed : parsed_) {
+      // already delivered, or a resend of one we're holding
+      const u16 distance = parsed.id - next_receive_id_;
+      auto& message = incoming(parsed.id);
+      if (distance >= kMessageWindow || message.received) {
+        continue;
+      }
+      std::copy_n(parsed.data.begin(), parsed.size, message.data.begin());
+      message.size = parsed.size;
+      message.received = true;
+    }
+
+    for (auto* message = &incoming(next_receive_id_); message->received;
+         message = &incoming(next_receive_id_)) {
+      on_message(std::span<const u8>{message->data}.first(message->size));
+      message->received = false;
+      ++next_receive_id_;
+    }
+    return true;
+  }
+
+  void on_packet_acked(u32 index) override;
+  void on_packet_lost(u32 index) override;
+
+  /*
+   * Messages sent that the other side hasn't acked yet.
+   */
+  u16 unacked_count() const noexcept { return next_id_ - oldest_unacked_; }
+
+ private:
+  struct OutgoingMessage {
+    bool acked = false;
+    bool in_flight = false;
+    u16 size = 0;
+    std::array<u8, kMaxMessageBytes> data;
+  };
+
+  struct IncomingMessage {
+    bool received = false;
+    u16 size = 0;
+    std::array<u8, kMaxMessageBytes> data;
+  };
+
+  struct ParsedMessage {
+    u16 id = 0;
+    u16 size = 0;
+    std::array<u8, kMaxMessageBytes> data;
+  };
+
+  struct SentPacket {
+    u32 index = 0;
+    FixedVec<u16, kMaxMessagesPerPacket> ids;
+  };
+
+  static constexpr std::size_t message_bits(u32 size) noexcept {
+    return kIdBits + MessageFraming::body_bits(size);
+  }
+
+  OutgoingMessage& outgoing(u16 id) noexcept {
+    return outgoing_[id % kMessageWindow];
+  }
+  IncomingMessage& incoming(u16 id) noexcept {
+    return incoming_[id % kMessageWindow];
+  }
+
+  bool unacked(u16 id) const noexcept {
+    return static_cast<u16>(id - oldest_unacked_) < unacked_count();
+  }
+
+ private:
+  u16 next_id_ = 0;
+  u16 oldest_unacked_ = 0;
+  u16 next_receive_id_ = 0;
+
+  std::array<OutgoingMessage, kMessageWindow> outgoing_;
+  std::array<IncomingMessage, kMessageWindow> incoming_;
+  std::array<SentPacket, Connection::kSentRingSize> sent_;
+
+  // read()'s messages until the whole packet checks out
+  FixedVec<ParsedMessage, kMaxMessagesPerPacket> parsed_;
+};
+}  // namespace glue::network
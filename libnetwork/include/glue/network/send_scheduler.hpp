@@ -0,0 +1,192 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <concepts>
+#include <glue/bitpack/bitpack.hpp>
+#include <glue/collections/fixed_vec.hpp>
+#include <glue/network/connection.hpp>
+#include <glue/network/message_framing.hpp>
+#include <glue/network/token_bucket.hpp>
+#include <glue/types.hpp>
+#include <span>
+
+namespace glue::network {
+/*
+ * Bandwidth budget for the unreliable messages of one connection, so a
+ * server replicating to many clients doesn't flood the slow ones and turn
+ * their loss into latency spikes.
+ *
+ * queue() messages with a priority and a deadline. Each tick, write() packs
+ * the most important ones that fit both the packet and the TokenBucket,
+ * highest priority then oldest first. The rest wait for a later tick.
+ * Messages still waiting past their deadline are dropped, stale state isn't
+ * worth the bandwidth.
+ *
+ * adapt() steers the rate from measured loss and RTT: cut it when packets
+ * are lost or start queueing in the network, grow it slowly otherwise.
+ *
+ * Wire format, written by write() and read by read(), see MessageFraming:
+ *   count : 5 bits
+ *   count times:
+ *     size  : 9 bits
+ *     bytes : size * 8 bits
+ */
+class SendScheduler final {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr u32 kMaxMessageBytes = MessageFraming::kMaxMessageBytes;
+  static constexpr u32 kMaxMessagesPerPacket =
+      MessageFraming::kMaxMessagesPerPacket;
+  static constexpr u32 kMaxQueued = 64;
+
+  static constexpr u32 kCountBits = MessageFraming::kCountBits;
+
+  struct Config {
+    // bytes per second
+    f64 initial_rate = 64.0 * 1024.0;
+    f64 min_rate = 8.0 * 1024.0;
+    f64 max_rate = 1024.0 * 1024.0;
+    f64 burst_bytes = 4.0 * 1200.0;
+
+    // adapt() counts the link as congested above this loss, or when the
+    // RTT grows past rtt_inflation times the lowest seen
+    f64 loss_threshold = 0.02;
+    f64 rtt_inflation = 1.5;
+
+    // multiplied in on congestion, added otherwise
+    f64 rate_decrease = 0.75;
+    f64 rate_increase = 4.0 * 1024.0;
+
+    // the lowest RTT is forgotten after this many adapt() calls without
+    // seeing it again, so a new route's higher RTT becomes the baseline
+    u32 min_rtt_window = 64;
+  };
+
+  SendScheduler() noexcept;
+  explicit SendScheduler(const Config& config) noexcept;
+
+  /*
+   * Queues a message to be sent by deadline. Higher priorities go first.
+   *
+   * Returns false, and counts the message dropped, if kMaxQueued messages
+   * are already waiting.
+   */
+  bool queue(std::span<const u8> message, u8 priority,
+             Clock::time_point deadline) noexcept;
+
+  /*
+   * Packs the queued messages that fit in max_bits and the budget, and
+   * charges the budget for them.
+   *
+   * Always writes at least kCountBits.
+   */
+  template <bitpack::CWritePacker T>
+  void write(T& packer, Clock::time_point now, std::size_t max_bits) {
+    glue_assert(max_bits >= kCountBits);
+
+    const auto picked = pick(now, max_bits);
+    u32 count = static_cast<u32>(picked.size());
+    MessageFraming::pack_count(packer, count);
+    for (u32 slot : picked) {
+      auto& message = queue_[slot];
+      message.queued = false;
+      sent_bytes_ += message.size;
+
+      u32 size = message.size;
+      MessageFraming::pack_size(packer, size);
+      bitpack::pack_bits(packer, std::span{message.data}.first(size), 0, 8);
+    }
+  }
+
+  /*
+   * Unpacks the messages written by write() and calls on_message with each.
+   *
+   * Returns false if the data is malformed, the packet should be dropped.
+   */
+  template <bitpack::CReadPacker T,
+            std::invocable<std::span<const u8>> OnMessage>
+  static bool read(T& unpacker, OnMessage&& on_message) {
+    u32 count = 0;
+    if (!MessageFraming::pack_count(unpacker, count)) {
+      return false;
+    }
+
+    std::array<u8, kMaxMessageBytes> scratch;
+    for (u32 i = 0; i < count; ++i) {
+      u32 size = 0;
+      if (!MessageFraming::pack_size(unpacker, size)) {
+        return false;
+      }
+      bitpack::pack_bits(unpacker, std::span{scratch}.first(size), 0, 8);
+      on_message(std::span<const u8>{scratch}.first(size));
+    }
+    return true;
+  }
+
+  /*
+   * Adjusts the rate from the connection's smoothed loss and RTT in
+   * seconds. Call about once per RTT, each call moves the rate one step.
+   */
+  void adapt(f64 packet_loss, f64 rtt) noexcept;
+  void adapt(const Connection& connection) noexcept {
+    adapt(connection.packet_loss(), connection.rtt());
+  }
+
+  /*
+   * For bytes sent outside the scheduler, e.g. headers and reliable
+   * messages, so they count against the same budget.
+   */
+  TokenBucket& budget() noexcept { return budget_; }
+  const TokenBucket& budget() const noexcept { return budget_; }
+
+  f64 rate() const noexcept { return budget_.rate(); }
+  u32 queued_count() const noexcept;
+
+  /*
+   * Message bytes sent, bytes that had to wait at least one write() for
+   * budget or space, and bytes dropped at their deadline or a full queue.
+   */
+  u64 sent_bytes() const noexcept { return sent_bytes_; }
+  u64 deferred_bytes() const noexcept { return deferred_bytes_; }
+  u64 dropped_bytes() const noexcept { return dropped_bytes_; }
+
+ private:
+  struct QueuedMessage {
+    bool queued = false;
+    bool deferred = false;
+    u8 priority = 0;
+    u16 size = 0;
+    u64 sequence = 0;
+    Clock::time_point deadline;
+    std::array<u8, kMaxMessageBytes> data;
+  };
+
+  static constexpr std::size_t message_bits(u32 size) noexcept {
+    return MessageFraming::body_bits(size);
+  }
+
+  /*
+   * Drops expired messages and picks the slots write() sends.
+   */
+  FixedVec<u32, kMaxMessagesPerPacket> pick(Clock::time_point now,
+                                            std::size_t max_bits) noexcept;
+
+ private:
+  Config config_;
+  TokenBucket budget_;
+  // the lowest RTT over the last one or two windows, and the lowest of
+  // the current one, which replaces it when the window ends
+  f64 min_rtt_ = 0.0;
+  f64 window_min_rtt_ = 0.0;
+  u32 window_samples_ = 0;
+
+  u64 next_sequence_ = 0;
+  std::array<QueuedMessage, kMaxQueued> queue_;
+
+  u64 sent_bytes_ = 0;
+  u64 deferred_bytes_ = 0;
+  u64 dropped_bytes_ = 0;
+};
+}  // namespace glue::network
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <functional>
+#include <glue/network/connection.hpp>
+#include <glue/network/event_loop.hpp>
+#include <glue/network/socket.hpp>
+#include <glue/network/telemetry.hpp>
+#include <glue/types.hpp>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace glue::network {
+/*
+ * Receives on one port with a worker thread per shard.
+ *
+ * Every shard owns a socket from Socket::open_shards() and an EventLoop.
+ * The kernel hashes each client to one shard, so a client's Connection
+ * lives on, and is only touched by, that shard's thread. Callbacks for
+ * different shards run concurrently, anything they share needs its own
+ * synchronization.
+ */
+class ShardedServer final {
+ public:
+  /*
+   * socket is the shard's own, for replies from the shard's thread. As with
+   * EventLoop, the callback passes headers to connection.on_receive().
+   */
+  using OnDatagramCallback = void(std::size_t shard, Socket& socket,
+                                  Connection& connection, std::span<u8> data);
+
+  ShardedServer(const ShardedServer&) = delete;
+  ShardedServer& operator=(const ShardedServer&) = delete;
+
+  /*
+   * Stops and joins every shard.
+   */
+  ~ShardedServer();
+
+  /*
+   * Opens shard_count sockets on port, any port if 0, and starts a thread
+   * draining each. nullptr if a socket or loop couldn't be created.
+   */
+  static std::unique_ptr<ShardedServer> start(
+      u16 port, std::size_t shard_count,
+      std::function<OnDatagramCallback> on_datagram);
+
+  /*
+   * Asks every shard to stop, doesn't wait for them.
+   */
+  void stop() noexcept;
+
+  u16 port() const noexcept { return port_; }
+  std::size_t shard_count() const noexcept { return shards_.size(); }
+
+  /*
+   * What shard's socket sent and received so far, safe to call from any
+   * thread while the shards run.
+   */
+  SocketStats socket_stats(std::size_t shard) const noexcept {
+    return shards_[shard]->telemetry.snapshot();
+  }
+
+ private:
+  ShardedServer() = default;
+
+  struct Shard {
+    Socket socket;
+    SocketTelemetry telemetry;
+    std::optional<EventLoop> loop;
+    std::thread thread;
+  };
+
+ private:
+  u16 port_ = 0;
+  std::function<OnDatagramCallback> on_datagram_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+}  // namespace glue::network
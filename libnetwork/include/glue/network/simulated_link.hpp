@@ -0,0 +1,139 @@
+#pragma once
+
+#include <chrono>
+#include <glue/network/address.hpp>
+#include <glue/network/socket.hpp>
+#include <glue/network/transport.hpp>
+#include <glue/types.hpp>
+#include <optional>
+#include <queue>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace glue::network {
+/*
+ * How a SimulatedLink mistreats datagrams, per direction.
+ */
+struct LinkConditions {
+  using Clock = std::chrono::steady_clock;
+
+  Clock::duration latency{};
+  Clock::duration jitter{};  // up to this much extra latency, uniform
+
+  f64 loss = 0.0;       // chance a datagram is dropped
+  f64 duplicate = 0.0;  // chance a datagram arrives twice
+  f64 reorder = 0.0;    // chance a datagram is held back by reorder_delay
+  Clock::duration reorder_delay{};
+
+  u64 bandwidth_bytes_per_sec = 0;  // 0 for unlimited
+};
+
+/*
+ * Two endpoints joined by a simulated network, for reproducible bad
+ * connections in tests and benchmarks without root or tc netem.
+ *
+ * Each Endpoint has Socket's send/receive surface (CTransport). Time only
+ * moves with advance(), and every random decision comes from one seeded
+ * RNG, so a run replays exactly, on any standard library.
+ *
+ * With a bandwidth cap, datagrams queue behind each other and leave one
+ * after the other, then take latency plus jitter to arrive.
+ */
+class SimulatedLink final {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  class Endpoint final {
+   public:
+    /*
+     * address must be the other endpoint's, anything else is dropped.
+     */
+    void send(const IPv4Address& address, std::span<u8> data);
+    /*
+     * Only datagrams that have arrived by the link's now(). Datagrams larger
+     * than data are dropped, like Socket.
+     */
+    std::optional<u32> receive(std::span<u8> data, IPv4Address& sender);
+    bool receive(Packet& packet, IPv4Address& sender);
+
+    std::size_t send_batch(std::span<const Datagram> datagrams);
+    std::size_t receive_batch(std::span<Datagram> datagrams);
+
+    const IPv4Address& address() const noexcept { return address_; }
+    u16 port() const noexcept { return address_.port(); }
+
+    /*
+     * Conditions for datagrams this endpoint sends.
+     */
+    LinkConditions& conditions() noexcept { return conditions_; }
+
+   private:
+    friend class SimulatedLink;
+
+    struct InFlight {
+      Clock::time_point arrival;
+      u64 sequence;  // keeps equal arrival times in send order
+      std::vector<u8> data;
+
+      friend bool operator>(const InFlight& a, const InFlight& b) noexcept {
+        return a.arrival != b.arrival ? a.arrival > b.arrival
+                                      : a.sequence > b.sequence;
+      }
+    };
+
+    Endpoint(SimulatedLink& link, IPv4Address address,
+             LinkConditions conditions) noexcept
+        : link_{&link}, address_{address}, conditions_{conditions} {}
+
+   private:
+    SimulatedLink* link_;
+    Endpoint* peer_ = nullptr;
+    IPv4Address address_;
+    LinkConditions conditions_;
+
+    // sending side: when the bandwidth-capped wire is free again
+    Clock::time_point wire_free_at_{};
+
+    // receiving side
+    std::priority_queue<InFlight, std::vector<InFlight>, std::greater<>>
+        incoming_;
+  };
+
+  SimulatedLink(IPv4Address a, IPv4Address b, LinkConditions conditions,
+                u32 seed);
+
+  SimulatedLink(const SimulatedLink&) = delete;
+  SimulatedLink& operator=(const SimulatedLink&) = delete;
+
+  Endpoint& a() noexcept { return a_; }
+  Endpoint& b() noexcept { return b_; }
+
+  Clock::time_point now() const noexcept { return now_; }
+  void advance(Clock::duration duration) noexcept { now_ += duration; }
+
+  u64 sent_count() const noexcept { return sent_count_; }
+  u64 dropped_count() const noexcept { return dropped_count_; }
+
+ private:
+  void transmit(Endpoint& from, std::span<const u8> data);
+
+  f64 uniform() noexcept;
+  bool roll(f64 chance) noexcept;
+  Clock::duration random_duration(Clock::duration max) noexcept;
+
+ private:
+  Clock::time_point now_{};
+  std::mt19937_64 rng_;
+  u64 next_sequence_ = 0;
+
+  u64 sent_count_ = 0;
+  u64 dropped_count_ = 0;
+
+  Endpoint a_;
+  Endpoint b_;
+};
+
+static_assert(CTransport<Socket>);
+static_assert(CTransport<SimulatedLink::Endpoint>);
+}  // namespace glue::network
@@ -1,18 +1,40 @@
 #pragma once
 
 #include <glue/network/address.hpp>
+#include <glue/network/packet.hpp>
+#include <glue/network/telemetry.hpp>
 #include <memory>
 #include <optional>
 #include <span>
+#include <vector>
 
 #include "detail/socket_handle.inl"
 
 namespace glue::network {
+/*
+ * One datagram of a batch, data is caller-provided storage.
+ *
+ * send_batch() sends all of data to address. receive_batch() fills data,
+ * sets size to the number of bytes received and address to the sender.
+ */
+struct Datagram {
+  std::span<u8> data;
+  u32 size = 0;
+  IPv4Address address;
+};
+
 /*
  * A raw UDP socket with non-blocking sends and receives.
  */
 class Socket final {
  public:
+  static constexpr std::size_t kMaxBatchSize = 64;
+
+  // Linux's limits for one UDP_SEGMENT send, the most one IPv4 UDP
+  // datagram can carry
+  static constexpr std::size_t kMaxSegments = 64;
+  static constexpr std::size_t kMaxSegmentedBytes = 65507;
+
   constexpr Socket() noexcept : handle_{0}, port_{0} {}
 
   Socket(const Socket&) = delete;
@@ -26,26 +48,162 @@ class Socket final {
 
   ~Socket();
 
-  static std::optional<Socket> open(u16 port);
+  /*
+   * reuse_port sets SO_REUSEPORT, see open_shards().
+   */
+  static std::optional<Socket> open(u16 port, bool reuse_port = false);
   static std::optional<Socket> open_any_port();
 
+  /*
+   * count sockets bound to the same port with SO_REUSEPORT, any port if
+   * port is 0. The kernel hashes each sender to one of them, so each can
+   * be drained by its own thread.
+   */
+  static std::optional<std::vector<Socket>> open_shards(u16 port,
+                                                        std::size_t count);
+
   void send(const IPv4Address& address, std::span<u8> data);
-  bool receive(std::span<u8> data, IPv4Address& sender);
+
+  /*
+   * Fixes the socket's peer with connect(), for clients that only talk to
+   * one server. The kernel does the route lookup once instead of per
+   * datagram, and drops datagrams from anyone else.
+   *
+   * The address taking send() and receive() keep working, the latter only
+   * ever reporting the peer.
+   */
+  bool connect(const IPv4Address& peer);
+
+  constexpr bool connected() const noexcept { return connected_; }
+  constexpr const IPv4Address& peer() const noexcept { return peer_; }
+
+  /*
+   * send() and receive() to and from the peer, only once connected.
+   */
+  void send(std::span<u8> data);
+  std::optional<u32> receive(std::span<u8> data);
+  bool receive(Packet& packet);
+
+  /*
+   * Size of the datagram received into data, nullopt if none was waiting.
+   * Datagrams larger than data are dropped.
+   */
+  std::optional<u32> receive(std::span<u8> data, IPv4Address& sender);
+
+  /*
+   * Receives a datagram straight into packet's data, see
+   * Packet::finish_receive(). packet's size is its capacity going in.
+   *
+   * Returns false if nothing was waiting or the datagram isn't a packet.
+   */
+  bool receive(Packet& packet, IPv4Address& sender);
+
+  /*
+   * Sends datagrams with as few syscalls as possible, kMaxBatchSize per call.
+   *
+   * Returns how many were sent, stops at the first failure.
+   */
+  std::size_t send_batch(std::span<const Datagram> datagrams);
+
+  /*
+   * Receives up to datagrams.size() waiting datagrams, kMaxBatchSize per
+   * syscall.
+   *
+   * Returns how many were received, those are at the front of datagrams.
+   * Datagrams larger than their buffer are dropped, the data spans of the
+   * ones after move up with them.
+   */
+  std::size_t receive_batch(std::span<Datagram> datagrams);
+
+  /*
+   * Opts in to UDP segmentation offload (Linux UDP_SEGMENT). send_segments()
+   * then hands the kernel a run of same-sized datagrams as one buffer, which
+   * goes through the stack once and is only split at the device.
+   *
+   * Returns false if the kernel doesn't support it, send_segments() then
+   * falls back to send_batch().
+   */
+  bool enable_gso();
+
+  /*
+   * Opts in to UDP receive offload (Linux UDP_GRO). Back to back datagrams
+   * of one size from one sender can then arrive coalesced, many per
+   * receive_segments().
+   *
+   * Returns false if the kernel doesn't support it, receive_segments() then
+   * gets one datagram per call.
+   */
+  bool enable_gro();
+
+  constexpr bool gso_enabled() const noexcept { return gso_; }
+  constexpr bool gro_enabled() const noexcept { return gro_; }
+
+  /*
+   * Sends data to address as datagrams of segment_size bytes, the last one
+   * possibly shorter. At most kMaxSegments datagrams and kMaxSegmentedBytes.
+   *
+   * Returns how many datagrams were sent.
+   */
+  std::size_t send_segments(const IPv4Address& address, std::span<u8> data,
+                            u16 segment_size);
+
+  /*
+   * Receives one or more coalesced datagrams from one sender into data.
+   * segment_size is set to the size of each but the last, which may be
+   * shorter. Without GRO that's always one datagram.
+   *
+   * Returns the total size, nullopt if nothing was waiting. data should
+   * hold kMaxSegmentedBytes, anything larger is dropped.
+   */
+  std::optional<u32> receive_segments(std::span<u8> data, IPv4Address& sender,
+                                      u16& segment_size);
 
   friend constexpr void swap(Socket& a, Socket& b) noexcept {
     using std::swap;
     swap(a.handle_, b.handle_);
     swap(a.port_, b.port_);
+    swap(a.connected_, b.connected_);
+    swap(a.peer_, b.peer_);
+    swap(a.gso_, b.gso_);
+    swap(a.gro_, b.gro_);
+    swap(a.telemetry_, b.telemetry_);
+  }
+
+  /*
+   * Counts every datagram sent, received or refused. Not owned, nullptr to
+   * stop recording. Snapshots can be read from any thread while this one
+   * records.
+   */
+  constexpr void set_telemetry(SocketTelemetry* telemetry) noexcept {
+    telemetry_ = telemetry;
   }
 
   constexpr u16 port() const noexcept { return port_; }
 
+  /*
+   * For registering with an event loop, don't close or read it directly.
+   */
+  constexpr detail::SocketHandle handle() const noexcept { return handle_; }
+
  private:
   constexpr Socket(detail::SocketHandle handle, u16 port) noexcept
       : handle_{handle}, port_{port} {}
 
+  /*
+   * Sets port_ to the port the socket is bound to.
+   */
+  bool fill_port();
+
  private:
   detail::SocketHandle handle_{0};
   u16 port_{0};
+
+  bool connected_ = false;
+  IPv4Address peer_;
+
+  bool gso_ = false;
+  bool gro_ = false;
+
+  SocketTelemetry* telemetry_ = nullptr;
 };
 }  // namespace glue::network
\ No newline at end of file
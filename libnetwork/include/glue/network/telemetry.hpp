@@ -0,0 +1,162 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <glue/types.hpp>
+
+namespace glue::network {
+/*
+ * Value distribution over fixed buckets.
+ *
+ * record() is a relaxed atomic increment, so the network thread never
+ * waits, and snapshot() can be taken from any other thread at any time. A
+ * snapshot taken during a record() may miss that sample, it's never torn.
+ */
+class Histogram final {
+ public:
+  static constexpr std::size_t kBuckets = 12;
+
+  // upper bounds of all but the last bucket, which takes everything above
+  using Bounds = std::array<f64, kBuckets - 1>;
+
+  struct Snapshot {
+    Bounds bounds{};
+    std::array<u64, kBuckets> counts{};
+
+    u64 total() const noexcept;
+
+    /*
+     * Upper bound of the bucket the sample at fraction (0 to 1) falls in,
+     * e.g. 0.99 for p99. The last bucket has none, it reports the highest
+     * bound instead.
+     */
+    f64 percentile(f64 fraction) const noexcept;
+  };
+
+  explicit constexpr Histogram(const Bounds& bounds) noexcept
+      : bounds_{bounds} {}
+
+  void record(f64 value, u64 count = 1) noexcept;
+  Snapshot snapshot() const noexcept;
+
+ private:
+  Bounds bounds_;
+  std::array<std::atomic<u64>, kBuckets> counts_{};
+};
+
+/*
+ * RTTs in seconds, and datagram and payload sizes in bytes.
+ */
+inline constexpr Histogram::Bounds kRttBounds{
+    0.001, 0.002, 0.005, 0.010, 0.020, 0.050,
+    0.075, 0.100, 0.150, 0.200, 0.500};
+inline constexpr Histogram::Bounds kSizeBounds{
+    32.0, 64.0, 128.0, 256.0, 512.0, 768.0,
+    1024.0, 1200.0, 1500.0, 9000.0, 65507.0};
+
+/*
+ * Copied out of SocketTelemetry, see Socket::set_telemetry().
+ */
+struct SocketStats {
+  u64 packets_sent = 0;
+  u64 bytes_sent = 0;
+  u64 packets_received = 0;
+  u64 bytes_received = 0;
+
+  // datagrams the kernel refused, e.g. with a full send buffer
+  u64 send_failures = 0;
+
+  Histogram::Snapshot sent_sizes;
+  Histogram::Snapshot received_sizes;
+};
+
+/*
+ * What a Socket sent and received, recorded by the socket's thread and read
+ * with snapshot() from any other, e.g. an overlay or a server's stats log.
+ */
+class SocketTelemetry final {
+ public:
+  void record_sent(u32 bytes, u64 count = 1) noexcept;
+  void record_received(u32 bytes, u64 count = 1) noexcept;
+  void record_send_failure(u64 count = 1) noexcept;
+
+  SocketStats snapshot() const noexcept;
+
+ private:
+  std::atomic<u64> packets_sent_ = 0;
+  std::atomic<u64> bytes_sent_ = 0;
+  std::atomic<u64> packets_received_ = 0;
+  std::atomic<u64> bytes_received_ = 0;
+  std::atomic<u64> send_failures_ = 0;
+
+  Histogram sent_sizes_{kSizeBounds};
+  Histogram received_sizes_{kSizeBounds};
+};
+
+/*
+ * Copied out of ConnectionTelemetry, see Connection::set_telemetry().
+ */
+struct ConnectionStats {
+  u64 packets_sent = 0;
+  u64 packets_received = 0;
+  u64 packets_acked = 0;
+  u64 packets_lost = 0;
+
+  // duplicates and packets too old to track
+  u64 packets_rejected = 0;
+
+  // payloads, as passed to record_payload_sent() / received()
+  u64 bytes_sent = 0;
+  u64 bytes_received = 0;
+
+  // Connection's smoothed values as of its last update
+  f64 packet_loss = 0.0;
+  f64 rtt = 0.0;
+  f64 jitter = 0.0;
+
+  Histogram::Snapshot rtt_samples;
+  Histogram::Snapshot sent_sizes;
+  Histogram::Snapshot received_sizes;
+};
+
+/*
+ * The packets, acks, losses and RTT samples of a Connection, and the
+ * payloads sent over it.
+ *
+ * Connection records everything but the payloads, it never sees those.
+ * Whoever packs and unpacks them calls record_payload_sent() and
+ * record_payload_received().
+ */
+class ConnectionTelemetry final {
+ public:
+  void record_payload_sent(u32 bytes) noexcept;
+  void record_payload_received(u32 bytes) noexcept;
+
+  void record_packet_sent() noexcept;
+  void record_packet_received() noexcept;
+  void record_packet_rejected() noexcept;
+  void record_packet_acked() noexcept;
+  void record_packet_lost() noexcept;
+  void record_rtt_sample(f64 sample, f64 rtt, f64 jitter) noexcept;
+  void set_packet_loss(f64 packet_loss) noexcept;
+
+  ConnectionStats snapshot() const noexcept;
+
+ private:
+  std::atomic<u64> packets_sent_ = 0;
+  std::atomic<u64> packets_received_ = 0;
+  std::atomic<u64> packets_acked_ = 0;
+  std::atomic<u64> packets_lost_ = 0;
+  std::atomic<u64> packets_rejected_ = 0;
+  std::atomic<u64> bytes_sent_ = 0;
+  std::atomic<u64> bytes_received_ = 0;
+
+  std::atomic<f64> packet_loss_ = 0.0;
+  std::atomic<f64> rtt_ = 0.0;
+  std::atomic<f64> jitter_ = 0.0;
+
+  Histogram rtt_samples_{kRttBounds};
+  Histogram sent_sizes_{kSizeBounds};
+  Histogram received_sizes_{kSizeBounds};
+};
+}  // namespace glue::network
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <glue/assert.hpp>
+#include <glue/types.hpp>
+#include <optional>
+
+namespace glue::network {
+/*
+ * Bytes per second with bursts: fills at rate up to burst bytes, sending
+ * spends from it.
+ *
+ * Starts full, so a new connection can send a burst straight away.
+ */
+class TokenBucket final {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  TokenBucket(f64 bytes_per_sec, f64 burst_bytes) noexcept
+      : rate_{bytes_per_sec}, burst_{burst_bytes}, tokens_{burst_bytes} {
+    glue_assert(bytes_per_sec >= 0.0);
+    glue_assert(burst_bytes >= 0.0);
+  }
+
+  /*
+   * Adds what accumulated since the last refill. The first call only
+   * starts the clock.
+   */
+  void refill(Clock::time_point now) noexcept {
+    if (last_refill_ && now > *last_refill_) {
+      const f64 elapsed =
+          std::chrono::duration<f64>(now - *last_refill_).count();
+      tokens_ = std::min(burst_, tokens_ + elapsed * rate_);
+    }
+    if (!last_refill_ || now > *last_refill_) {
+      last_refill_ = now;
+    }
+  }
+
+  /*
+   * Spends bytes if there are enough, otherwise spends nothing.
+   */
+  bool try_consume(f64 bytes) noexcept {
+    if (tokens_ < bytes) {
+      return false;
+    }
+    tokens_ -= bytes;
+    return true;
+  }
+
+  /*
+   * Spends bytes even if there aren't enough, e.g. for a packet that has
+   * to go out anyway. Later sends wait until the debt is paid off.
+   */
+  void consume(f64 bytes) noexcept { tokens_ -= bytes; }
+
+  /*
+   * Changes the fill rate from now on, bytes already in the bucket stay.
+   */
+  void set_rate(f64 bytes_per_sec) noexcept {
+    glue_assert(bytes_per_sec >= 0.0);
+    rate_ = bytes_per_sec;
+  }
+
+  void set_burst(f64 burst_bytes) noexcept {
+    glue_assert(burst_bytes >= 0.0);
+    burst_ = burst_bytes;
+    tokens_ = std::min(tokens_, burst_);
+  }
+
+  f64 rate() const noexcept { return rate_; }
+  f64 burst() const noexcept { return burst_; }
+
+  /*
+   * Negative while paying off consume() debt.
+   */
+  f64 available() const noexcept { return tokens_; }
+
+ private:
+  f64 rate_;
+  f64 burst_;
+  f64 tokens_;
+  std::optional<Clock::time_point> last_refill_;
+};
+}  // namespace glue::network
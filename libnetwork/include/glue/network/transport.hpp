@@ -0,0 +1,20 @@
+#pragma once
+
+#include <concepts>
+#include <glue/network/address.hpp>
+#include <glue/types.hpp>
+#include <optional>
+#include <span>
+
+namespace glue::network {
+/*
+ * Anything with Socket's datagram surface, so code can run over a real
+ * Socket or a SimulatedLink.
+ */
+template <typename T>
+concept CTransport = requires(T transport, const IPv4Address& address,
+                              std::span<u8> data, IPv4Address& sender) {
+  { transport.send(address, data) } -> std::same_as<void>;
+  { transport.receive(data, sender) } -> std::same_as<std::optional<u32>>;
+};
+}  // namespace glue::network
@@ -0,0 +1,170 @@
+#include <glog/logging.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <array>
+#include <glue/debug/timer.hpp>
+#include <glue/network/compression.hpp>
+#include <glue/network/cube_state.hpp>
+#include <vector>
+
+namespace glue::network {
+namespace {
+/*
+ * Raw deflate with a 4KB window, enough to reach back over the dictionary
+ * from the end of a kMaxPayloadBytes payload. With memLevel 5 that's about
+ * 32KB of deflate state per connection instead of zlib's default 256KB.
+ */
+constexpr i32 kWindowBits = -12;
+constexpr i32 kMemLevel = 5;
+
+/*
+ * A join snapshot of the first rows of cubes at rest, packed like any
+ * other CubeState message. deflate matches best against the end of the
+ * dictionary, and rest poses are what most of a join payload is.
+ */
+std::vector<u8> make_default_dictionary() {
+  constexpr u16 kCubes = 90;
+  constexpr u32 kCubeBits = 16 + CubePoseQuantize::kPackedBits;
+
+  std::vector<u32> words(kCubes * kCubeBits / 32 + 1);
+  bitpack::Packer packer{words};
+  for (u16 index = 1; index <= kCubes; ++index) {
+    auto cube = resting_cube(index);
+    pack(packer, cube);
+  }
+
+  const auto* bytes = reinterpret_cast<const u8*>(words.data());
+  return {bytes, bytes + (packer.current_bit() + 7) / 8};
+}
+}  // namespace
+
+struct PayloadCompressor::State {
+  z_stream deflate{};
+  z_stream inflate{};
+  bool deflate_ready = false;
+  bool inflate_ready = false;
+
+  std::vector<u8> dictionary;
+
+  std::array<u8, kMaxPayloadBytes> write_buffer;
+  std::array<u8, kMaxPayloadBytes> read_buffer;
+  std::array<u8, kMaxPayloadBytes> payload_buffer;
+
+  ~State() {
+    if (deflate_ready) {
+      deflateEnd(&deflate);
+    }
+    if (inflate_ready) {
+      inflateEnd(&inflate);
+    }
+  }
+};
+
+PayloadCompressor::PayloadCompressor(std::unique_ptr<State> state) noexcept
+    : state_{std::move(state)} {}
+
+PayloadCompressor::PayloadCompressor(PayloadCompressor&&) noexcept = default;
+PayloadCompressor& PayloadCompressor::operator=(PayloadCompressor&&) noexcept =
+    default;
+PayloadCompressor::~PayloadCompressor() = default;
+
+std::optional<PayloadCompressor> PayloadCompressor::create(
+    std::span<const u8> dictionary, i32 level) {
+  auto state = std::make_unique<State>();
+  state->dictionary.assign(dictionary.begin(), dictionary.end());
+
+  if (deflateInit2(&state->deflate, level, Z_DEFLATED, kWindowBits, kMemLevel,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    LOG(ERROR) << "Failed to create deflate stream";
+    return std::nullopt;
+  }
+  state->deflate_ready = true;
+
+  if (inflateInit2(&state->inflate, kWindowBits) != Z_OK) {
+    LOG(ERROR) << "Failed to create inflate stream";
+    return std::nullopt;
+  }
+  state->inflate_ready = true;
+
+  return PayloadCompressor{std::move(state)};
+}
+
+std::span<const u8> PayloadCompressor::default_dictionary() {
+  static const std::vector<u8> dictionary = make_default_dictionary();
+  return dictionary;
+}
+
+std::optional<u32> PayloadCompressor::compress(std::span<const u8> payload,
+                                               std::span<u8> out) {
+  debug::Timer timer;
+  auto& stream = state_->deflate;
+
+  // raw deflate takes the dictionary straight after a reset, neither
+  // allocates
+  deflateReset(&stream);
+  if (!state_->dictionary.empty()) {
+    deflateSetDictionary(&stream, state_->dictionary.data(),
+                         static_cast<uInt>(state_->dictionary.size()));
+  }
+
+  // stop as soon as it's no smaller than the payload
+  stream.next_in = const_cast<Bytef*>(payload.data());
+  stream.avail_in = static_cast<uInt>(payload.size());
+  stream.next_out = out.data();
+  const std::size_t limit = payload.empty() ? 0 : payload.size() - 1;
+  stream.avail_out = static_cast<uInt>(std::min(out.size(), limit));
+  const bool finished = deflate(&stream, Z_FINISH) == Z_STREAM_END;
+  const auto size = static_cast<u32>(stream.total_out);
+
+  stats_.attempted++;
+  stats_.bytes_in += payload.size();
+  stats_.bytes_out += finished ? size : payload.size();
+  stats_.compressed += finished ? 1 : 0;
+  stats_.compress_sec += timer.elapsed_sec<f64>();
+
+  if (!finished) {
+    return std::nullopt;
+  }
+  return size;
+}
+
+std::optional<u32> PayloadCompressor::decompress(
+    std::span<const u8> compressed, std::span<u8> out) {
+  debug::Timer timer;
+  auto& stream = state_->inflate;
+
+  inflateReset(&stream);
+  if (!state_->dictionary.empty()) {
+    inflateSetDictionary(&stream, state_->dictionary.data(),
+                         static_cast<uInt>(state_->dictionary.size()));
+  }
+
+  stream.next_in = const_cast<Bytef*>(compressed.data());
+  stream.avail_in = static_cast<uInt>(compressed.size());
+  stream.next_out = out.data();
+  stream.avail_out = static_cast<uInt>(out.size());
+  const bool finished = inflate(&stream, Z_FINISH) == Z_STREAM_END;
+  const auto size = static_cast<u32>(stream.total_out);
+
+  stats_.decompressed++;
+  stats_.decompress_sec += timer.elapsed_sec<f64>();
+
+  if (!finished) {
+    return std::nullopt;
+  }
+  return size;
+}
+
+std::span<u8> PayloadCompressor::write_buffer() noexcept {
+  return state_->write_buffer;
+}
+
+std::span<u8> PayloadCompressor::read_buffer() noexcept {
+  return state_->read_buffer;
+}
+
+std::span<u8> PayloadCompressor::payload_buffer() noexcept {
+  return state_->payload_buffer;
+}
+}  // namespace glue::network
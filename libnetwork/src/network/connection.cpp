@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <cmath>
+#include <glue/network/connection.hpp>
+#include <glue/sequence.hpp>
+
+namespace glue::network {
+PacketHeader Connection::next_header(Clock::time_point now) noexcept {
+  const u32 index = next_index_++;
+
+  // the slot we're about to reuse can't be acked anymore
+  if (index >= kSentRingSize) {
+    resolve_until(index - kSentRingSize + 1);
+  }
+  sent(index) = {index, false, now};
+  ++sent_count_;
+  if (telemetry_ != nullptr) {
+    telemetry_->record_packet_sent();
+  }
+
+  return {index, received_.latest(), received_.present_flags()};
+}
+
+bool Connection::on_receive(const PacketHeader& header,
+                            Clock::time_point now) noexcept {
+  const u32 index = unwrap_sequence(static_cast<u16>(header.index),
+                                    received_.latest());
+  if (index < received_.oldest() || received_[index]) {
+    if (telemetry_ != nullptr) {
+      telemetry_->record_packet_rejected();
+    }
+    return false;
+  }
+  received_.mark(index);
+  if (telemetry_ != nullptr) {
+    telemetry_->record_packet_received();
+  }
+
+  // a receipt newer than our newest packet acks packets we never sent,
+  // otherwise it's how far behind that it is
+  const u32 newest_sent = next_index_ - 1;
+  if (sequence_greater_than(static_cast<u16>(header.receipt_index),
+                            static_cast<u16>(newest_sent))) {
+    return true;
+  }
+  const auto receipt_delta =
+      static_cast<u16>(newest_sent - header.receipt_index);
+  const u32 receipt_index =
+      receipt_delta <= newest_sent ? newest_sent - receipt_delta : 0;
+
+  const PresenceWindow acks{receipt_index, header.receipt_flags};
+  const u32 first = std::max(acks.oldest(), resolved_until_);
+  const u32 last = std::min(acks.latest() + 1, next_index_);
+  for (u32 index = first; index < last; ++index) {
+    auto& packet = sent(index);
+    if (packet.index != index || packet.acked || !acks[index]) {
+      continue;
+    }
+    packet.acked = true;
+    ++acked_count_;
+    if (listener_ != nullptr) {
+      listener_->on_packet_acked(index);
+    }
+    if (telemetry_ != nullptr) {
+      telemetry_->record_packet_acked();
+    }
+
+    // acks for older packets may have been lost and repeated, which would
+    // inflate the sample, so only time the packet being acked directly
+    if (index == acks.latest()) {
+      add_rtt_sample(std::chrono::duration<f64>(now - packet.sent_at).count());
+    }
+  }
+
+  resolve_until(std::min(acks.oldest(), next_index_));
+  return true;
+}
+
+void Connection::add_rtt_sample(f64 sample) noexcept {
+  if (rtt_ == 0.0) {
+    rtt_ = sample;
+    jitter_ = sample / 2.0;
+  } else {
+    jitter_ += kJitterGain * (std::abs(rtt_ - sample) - jitter_);
+    rtt_ += kRttGain * (sample - rtt_);
+  }
+
+  if (telemetry_ != nullptr) {
+    telemetry_->record_rtt_sample(sample, rtt_, jitter_);
+  }
+}
+
+void Connection::resolve_until(u32 boundary) noexcept {
+  const u32 first = resolved_until_;
+  for (; resolved_until_ < boundary; ++resolved_until_) {
+    const auto& packet = sent(resolved_until_);
+    if (packet.index != resolved_until_) {
+      continue;
+    }
+
+    if (!packet.acked) {
+      ++lost_count_;
+      if (listener_ != nullptr) {
+        listener_->on_packet_lost(resolved_until_);
+      }
+      if (telemetry_ != nullptr) {
+        telemetry_->record_packet_lost();
+      }
+    }
+    const f64 lost = packet.acked ? 0.0 : 1.0;
+    packet_loss_ += kLossGain * (lost - packet_loss_);
+  }
+
+  if (telemetry_ != nullptr && resolved_until_ != first) {
+    telemetry_->set_packet_loss(packet_loss_);
+  }
+}
+}  // namespace glue::network
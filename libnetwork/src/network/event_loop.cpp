@@ -0,0 +1,218 @@
+#include <glog/logging.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <glue/network/event_loop.hpp>
+#include <limits>
+
+namespace glue::network {
+namespace {
+// epoll_event::data for the stop event, sources use their index
+constexpr u64 kStopEventTag = ~u64{0};
+
+timespec to_timespec(EventLoop::Clock::duration duration) noexcept {
+  const auto ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+  return {static_cast<time_t>(ns / 1'000'000'000),
+          static_cast<long>(ns % 1'000'000'000)};
+}
+}  // namespace
+
+EventLoop::~EventLoop() {
+  for (const auto& source : sources_) {
+    if (source.socket == nullptr) {
+      close(source.fd);
+    }
+  }
+  if (stop_event_ >= 0) {
+    close(stop_event_);
+  }
+  if (epoll_ >= 0) {
+    close(epoll_);
+  }
+}
+
+std::optional<EventLoop> EventLoop::create() {
+  EventLoop out;
+  out.epoll_ = epoll_create1(EPOLL_CLOEXEC);
+  if (out.epoll_ < 0) {
+    LOG(ERROR) << "Failed to create epoll instance";
+    return std::nullopt;
+  }
+
+  out.stop_event_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (out.stop_event_ < 0) {
+    LOG(ERROR) << "Failed to create stop eventfd";
+    return std::nullopt;
+  }
+
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.u64 = kStopEventTag;
+  if (epoll_ctl(out.epoll_, EPOLL_CTL_ADD, out.stop_event_, &event) != 0) {
+    LOG(ERROR) << "Failed to watch stop eventfd";
+    return std::nullopt;
+  }
+
+  out.buffers_.resize(Socket::kMaxBatchSize);
+  out.datagrams_.resize(Socket::kMaxBatchSize);
+  for (std::size_t i = 0; i < out.buffers_.size(); ++i) {
+    out.datagrams_[i].data = out.buffers_[i];
+  }
+
+  return {std::move(out)};
+}
+
+bool EventLoop::add_socket(Socket& socket,
+                           std::function<OnDatagramCallback> on_datagram) {
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.u64 = sources_.size();
+  if (epoll_ctl(epoll_, EPOLL_CTL_ADD, socket.handle(), &event) != 0) {
+    LOG(ERROR) << "Failed to watch UDP socket on port " << socket.port();
+    return false;
+  }
+
+  sources_.push_back({socket.handle(), &socket, std::move(on_datagram), {}});
+  return true;
+}
+
+bool EventLoop::add_timer(Clock::duration interval,
+                          std::function<OnTimerCallback> on_timer) {
+  glue_assert(interval > Clock::duration::zero());
+  const i32 timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (timer < 0) {
+    LOG(ERROR) << "Failed to create timerfd";
+    return false;
+  }
+
+  itimerspec spec{};
+  spec.it_interval = to_timespec(interval);
+  spec.it_value = to_timespec(interval);
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.u64 = sources_.size();
+  if (timerfd_settime(timer, 0, &spec, nullptr) != 0 ||
+      epoll_ctl(epoll_, EPOLL_CTL_ADD, timer, &event) != 0) {
+    LOG(ERROR) << "Failed to start timer";
+    close(timer);
+    return false;
+  }
+
+  sources_.push_back({timer, nullptr, {}, std::move(on_timer)});
+  return true;
+}
+
+void EventLoop::run() {
+  while (run_once(Clock::duration::max())) {
+  }
+}
+
+bool EventLoop::run_once(Clock::duration timeout) {
+  if (stopped_) {
+    return false;
+  }
+
+  // epoll_wait only takes milliseconds, round up so we don't spin. Too
+  // long for an i32 is as good as forever
+  i32 timeout_ms = -1;
+  constexpr auto kMaxTimeout =
+      std::chrono::milliseconds{std::numeric_limits<i32>::max()};
+  if (timeout < kMaxTimeout) {
+    timeout_ms = static_cast<i32>(std::max<i64>(
+        0, std::chrono::ceil<std::chrono::milliseconds>(timeout).count()));
+  }
+
+  std::array<epoll_event, kMaxEvents> events;
+  const i32 count =
+      epoll_wait(epoll_, events.data(), static_cast<i32>(events.size()),
+                 timeout_ms);
+  for (i32 i = 0; i < count; ++i) {
+    const u64 tag = events[i].data.u64;
+    if (tag == kStopEventTag) {
+      stopped_ = true;
+      continue;
+    }
+
+    auto& source = sources_[tag];
+    if (source.socket != nullptr) {
+      drain(source);
+    } else {
+      fire(source);
+    }
+  }
+
+  const auto now = Clock::now();
+  if (now >= next_expiry_) {
+    expire_idle(now);
+  }
+  return !stopped_;
+}
+
+void EventLoop::stop() noexcept {
+  const u64 one = 1;
+  [[maybe_unused]] const auto written = write(stop_event_, &one, sizeof(one));
+}
+
+void EventLoop::set_connection_limits(std::size_t max_connections,
+                                      Clock::duration idle_timeout) noexcept {
+  glue_assert(idle_timeout > Clock::duration::zero());
+  max_connections_ = max_connections;
+  idle_timeout_ = idle_timeout;
+  next_expiry_ = {};
+}
+
+Connection* EventLoop::find_connection(const IPv4Address& address) noexcept {
+  const auto it = connections_.find(address);
+  return it == connections_.end() ? nullptr : &it->second.connection;
+}
+
+Connection* EventLoop::connection_for(const IPv4Address& address,
+                                      Clock::time_point now) {
+  auto it = connections_.find(address);
+  if (it == connections_.end()) {
+    if (connections_.size() >= max_connections_) {
+      expire_idle(now);
+    }
+    if (connections_.size() >= max_connections_) {
+      return nullptr;
+    }
+    it = connections_.try_emplace(address, Connection{address}, now).first;
+  }
+  it->second.last_received = now;
+  return &it->second.connection;
+}
+
+void EventLoop::expire_idle(Clock::time_point now) {
+  std::erase_if(connections_, [&](const auto& entry) {
+    return now - entry.second.last_received >= idle_timeout_;
+  });
+  next_expiry_ = now + idle_timeout_ / 2;
+}
+
+void EventLoop::drain(Source& source) {
+  // one batch per wakeup, so a flooded socket can't starve timers, expiry
+  // and stop(). The socket is level-triggered, epoll reports the rest.
+  const std::size_t received = source.socket->receive_batch(datagrams_);
+  const auto now = Clock::now();
+  for (std::size_t i = 0; i < received; ++i) {
+    auto& datagram = datagrams_[i];
+    Connection* connection = connection_for(datagram.address, now);
+    if (connection == nullptr) {
+      ++refused_count_;
+      continue;
+    }
+    source.on_datagram(*connection, datagram.data.first(datagram.size));
+  }
+}
+
+void EventLoop::fire(Source& source) {
+  u64 expirations = 0;
+  if (read(source.fd, &expirations, sizeof(expirations)) > 0) {
+    source.on_timer();
+  }
+}
+}  // namespace glue::network
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <glue/network/fragment.hpp>
+
+namespace glue::network {
+Reassembler::Reassembler(std::size_t max_payload_words,
+                         Clock::duration timeout)
+    : timeout_{timeout},
+      buffer_(max_payload_words),
+      received_(fragment_count(max_payload_words)) {
+  glue_assert(received_.size() <= kMaxFragments);
+}
+
+void Reassembler::update(Clock::time_point now) noexcept {
+  if (collecting_ && now - last_fragment_at_ > timeout_) {
+    collecting_ = false;
+  }
+}
+
+u32* Reassembler::begin_fragment(const FragmentHeader& header,
+                                 Clock::time_point now) noexcept {
+  const bool last = header.index + 1 == header.count;
+  const std::size_t offset = header.index * std::size_t{kFragmentWords};
+  if (header.index >= header.count || header.count > received_.size() ||
+      (last ? header.words == 0 : header.words != kFragmentWords) ||
+      offset + header.words > buffer_.size()) {
+    return nullptr;
+  }
+
+  update(now);
+  if (collecting_ || completed_) {
+    // newer groups are up to half the u16 range ahead
+    const u16 ahead = header.group - group_;
+    if (ahead == 0) {
+      if (completed_ || header.count != count_) {
+        return nullptr;
+      }
+    } else if (ahead < 0x8000) {
+      start_group(header, now);
+    } else {
+      return nullptr;
+    }
+  } else {
+    start_group(header, now);
+  }
+
+  if (!collecting_ || received_[header.index]) {
+    return nullptr;
+  }
+  last_fragment_at_ = now;
+  return buffer_.data() + offset;
+}
+
+std::optional<std::span<const u32>> Reassembler::end_fragment(
+    const FragmentHeader& header) noexcept {
+  received_[header.index] = true;
+  ++received_count_;
+  if (header.index + 1 == header.count) {
+    payload_words_ = header.index * std::size_t{kFragmentWords} + header.words;
+  }
+
+  if (received_count_ < count_) {
+    return std::nullopt;
+  }
+  collecting_ = false;
+  completed_ = true;
+  return std::span<const u32>{buffer_.data(), payload_words_};
+}
+
+void Reassembler::start_group(const FragmentHeader& header,
+                              Clock::time_point now) noexcept {
+  collecting_ = true;
+  completed_ = false;
+  group_ = header.group;
+  count_ = header.count;
+  received_count_ = 0;
+  payload_words_ = 0;
+  last_fragment_at_ = now;
+  std::fill(received_.begin(), received_.end(), false);
+}
+}  // namespace glue::network
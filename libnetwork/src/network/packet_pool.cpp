@@ -0,0 +1,62 @@
+#include <glue/assert.hpp>
+#include <glue/network/packet_pool.hpp>
+
+namespace glue::network {
+PacketPool::PacketPool(u32 packet_size, u32 capacity)
+    : packet_size_{packet_size},
+      capacity_{capacity},
+      slot_size_{Packet::alloc_size_bytes(packet_size)},
+      slab_{new u8[slot_size_ * capacity]},
+      next_{new std::atomic<u32>[capacity]},
+      head_{make_head(0, capacity == 0 ? kEnd : 0)} {
+  glue_assert(capacity < kEnd);
+  glue_assert(ptr_is_aligned(slab_.get(), Packet::kAlignment));
+  for (u32 i = 0; i < capacity; ++i) {
+    next_[i].store(i + 1 < capacity ? i + 1 : kEnd, std::memory_order_relaxed);
+  }
+}
+
+Packet* PacketPool::acquire(const PacketHeader& header) noexcept {
+  u64 head = head_.load(std::memory_order_acquire);
+  for (;;) {
+    const u32 index = head_index(head);
+    if (index == kEnd) {
+      return nullptr;
+    }
+
+    // may be stale if another thread popped index first, the tag makes the
+    // exchange fail in that case
+    const u32 next = next_[index].load(std::memory_order_relaxed);
+    if (head_.compare_exchange_weak(head, make_head(head_tag(head) + 1, next),
+                                    std::memory_order_acquire,
+                                    std::memory_order_acquire)) {
+      return Packet::unsafe_init(slot(index), packet_size_, header);
+    }
+  }
+}
+
+void PacketPool::release(Packet* packet) noexcept {
+  glue_assert(owns(packet));
+  const auto offset = reinterpret_cast<u8*>(packet) - slab_.get();
+  const u32 index = static_cast<u32>(offset / slot_size_);
+
+  u64 head = head_.load(std::memory_order_relaxed);
+  for (;;) {
+    next_[index].store(head_index(head), std::memory_order_relaxed);
+    if (head_.compare_exchange_weak(head,
+                                    make_head(head_tag(head) + 1, index),
+                                    std::memory_order_release,
+                                    std::memory_order_relaxed)) {
+      return;
+    }
+  }
+}
+
+bool PacketPool::owns(const Packet* packet) const noexcept {
+  const auto* start = reinterpret_cast<const u8*>(packet);
+  if (start < slab_.get() || start >= slot(capacity_)) {
+    return false;
+  }
+  return (start - slab_.get()) % slot_size_ == 0;
+}
+}  // namespace glue::network
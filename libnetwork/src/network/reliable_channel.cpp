@@ -0,0 +1,51 @@
+#include <algorithm>
+#include <glue/network/reliable_channel.hpp>
+
+namespace glue::network {
+bool ReliableChannel::send(std::span<const u8> message) noexcept {
+  glue_assert(message.size() <= kMaxMessageBytes);
+  if (unacked_count() >= kMessageWindow) {
+    return false;
+  }
+
+  auto& slot = outgoing(next_id_++);
+  slot.acked = false;
+  slot.in_flight = false;
+  slot.size = static_cast<u16>(message.size());
+  std::copy(message.begin(), message.end(), slot.data.begin());
+  return true;
+}
+
+void ReliableChannel::on_packet_acked(u32 index) {
+  auto& record = sent_[index % Connection::kSentRingSize];
+  if (record.index != index) {
+    return;
+  }
+
+  for (u16 id : record.ids) {
+    if (unacked(id)) {
+      outgoing(id).acked = true;
+    }
+  }
+  record.ids.clear();
+
+  while (oldest_unacked_ != next_id_ && outgoing(oldest_unacked_).acked) {
+    ++oldest_unacked_;
+  }
+}
+
+void ReliableChannel::on_packet_lost(u32 index) {
+  auto& record = sent_[index % Connection::kSentRingSize];
+  if (record.index != index) {
+    return;
+  }
+
+  // picked up again by the next write()
+  for (u16 id : record.ids) {
+    if (unacked(id)) {
+      outgoing(id).in_flight = false;
+    }
+  }
+  record.ids.clear();
+}
+}  // namespace glue::network
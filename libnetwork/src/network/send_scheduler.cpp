@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <glue/network/send_scheduler.hpp>
+
+namespace glue::network {
+SendScheduler::SendScheduler() noexcept : SendScheduler{Config{}} {}
+
+SendScheduler::SendScheduler(const Config& config) noexcept
+    : config_{config}, budget_{config.initial_rate, config.burst_bytes} {
+  glue_assert(config.min_rate <= config.initial_rate);
+  glue_assert(config.initial_rate <= config.max_rate);
+  glue_assert(config.min_rtt_window > 0);
+}
+
+bool SendScheduler::queue(std::span<const u8> message, u8 priority,
+                          Clock::time_point deadline) noexcept {
+  glue_assert(message.size() <= kMaxMessageBytes);
+
+  const auto slot = std::find_if(queue_.begin(), queue_.end(),
+                                 [](const auto& m) { return !m.queued; });
+  if (slot == queue_.end()) {
+    dropped_bytes_ += message.size();
+    return false;
+  }
+
+  slot->queued = true;
+  slot->deferred = false;
+  slot->priority = priority;
+  slot->size = static_cast<u16>(message.size());
+  slot->sequence = next_sequence_++;
+  slot->deadline = deadline;
+  std::copy(message.begin(), message.end(), slot->data.begin());
+  return true;
+}
+
+void SendScheduler::adapt(f64 packet_loss, f64 rtt) noexcept {
+  // the lowest RTT is the link without our own queueing on top
+  if (rtt > 0.0) {
+    min_rtt_ = min_rtt_ == 0.0 ? rtt : std::min(min_rtt_, rtt);
+    window_min_rtt_ =
+        window_min_rtt_ == 0.0 ? rtt : std::min(window_min_rtt_, rtt);
+    if (++window_samples_ >= config_.min_rtt_window) {
+      min_rtt_ = window_min_rtt_;
+      window_min_rtt_ = 0.0;
+      window_samples_ = 0;
+    }
+  }
+
+  const bool congested =
+      packet_loss > config_.loss_threshold ||
+      (min_rtt_ > 0.0 && rtt > min_rtt_ * config_.rtt_inflation);
+  const f64 next_rate = congested ? rate() * config_.rate_decrease
+                                  : rate() + config_.rate_increase;
+  budget_.set_rate(
+      std::clamp(next_rate, config_.min_rate, config_.max_rate));
+}
+
+u32 SendScheduler::queued_count() const noexcept {
+  return static_cast<u32>(std::count_if(
+      queue_.begin(), queue_.end(), [](const auto& m) { return m.queued; }));
+}
+
+FixedVec<u32, SendScheduler::kMaxMessagesPerPacket> SendScheduler::pick(
+    Clock::time_point now, std::size_t max_bits) noexcept {
+  budget_.refill(now);
+
+  FixedVec<u32, kMaxQueued> waiting;
+  for (u32 slot = 0; slot < kMaxQueued; ++slot) {
+    auto& message = queue_[slot];
+    if (!message.queued) {
+      continue;
+    }
+    if (message.deadline < now) {
+      message.queued = false;
+      dropped_bytes_ += message.size;
+      continue;
+    }
+    waiting.push_back(slot);
+  }
+  std::sort(waiting.begin(), waiting.end(), [&](u32 a, u32 b) {
+    const auto& x = queue_[a];
+    const auto& y = queue_[b];
+    return x.priority != y.priority ? x.priority > y.priority
+                                    : x.sequence < y.sequence;
+  });
+
+  // a message that doesn't fit doesn't stop smaller ones behind it
+  const auto budget_bits =
+      static_cast<std::size_t>(std::max(0.0, budget_.available()) * 8.0);
+  const std::size_t allowed = std::min(max_bits, kCountBits + budget_bits);
+  std::size_t bits = kCountBits;
+  FixedVec<u32, kMaxMessagesPerPacket> picked;
+  for (u32 slot : waiting) {
+    auto& message = queue_[slot];
+    const std::size_t needed = message_bits(message.size);
+    if (!picked.full() && bits + needed <= allowed) {
+      picked.push_back(slot);
+      bits += needed;
+      continue;
+    }
+
+    if (!message.deferred) {
+      message.deferred = true;
+      deferred_bytes_ += message.size;
+    }
+  }
+
+  // an empty count is sent with whatever else is in the packet anyway
+  if (!picked.empty()) {
+    budget_.consume(static_cast<f64>((bits + 7) / 8));
+  }
+  return picked;
+}
+}  // namespace glue::network
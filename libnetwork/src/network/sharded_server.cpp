@@ -0,0 +1,60 @@
+#include <glue/network/sharded_server.hpp>
+
+namespace glue::network {
+ShardedServer::~ShardedServer() {
+  stop();
+  for (auto& shard : shards_) {
+    if (shard->thread.joinable()) {
+      shard->thread.join();
+    }
+  }
+}
+
+std::unique_ptr<ShardedServer> ShardedServer::start(
+    u16 port, std::size_t shard_count,
+    std::function<OnDatagramCallback> on_datagram) {
+  auto sockets = Socket::open_shards(port, shard_count);
+  if (!sockets.has_value()) {
+    return nullptr;
+  }
+
+  std::unique_ptr<ShardedServer> server{new ShardedServer};
+  server->port_ = sockets->front().port();
+  server->on_datagram_ = std::move(on_datagram);
+
+  // set up every shard before starting any thread, so a failure doesn't
+  // leave threads behind to clean up
+  for (std::size_t i = 0; i < shard_count; ++i) {
+    auto shard = std::make_unique<Shard>();
+    shard->socket = std::move((*sockets)[i]);
+    shard->socket.set_telemetry(&shard->telemetry);
+    shard->loop = EventLoop::create();
+    if (!shard->loop.has_value()) {
+      return nullptr;
+    }
+
+    auto* server_ptr = server.get();
+    auto* shard_ptr = shard.get();
+    const bool added = shard->loop->add_socket(
+        shard->socket,
+        [server_ptr, shard_ptr, i](Connection& connection, std::span<u8> data) {
+          server_ptr->on_datagram_(i, shard_ptr->socket, connection, data);
+        });
+    if (!added) {
+      return nullptr;
+    }
+    server->shards_.push_back(std::move(shard));
+  }
+
+  for (auto& shard : server->shards_) {
+    shard->thread = std::thread{[loop = &*shard->loop] { loop->run(); }};
+  }
+  return server;
+}
+
+void ShardedServer::stop() noexcept {
+  for (auto& shard : shards_) {
+    shard->loop->stop();
+  }
+}
+}  // namespace glue::network
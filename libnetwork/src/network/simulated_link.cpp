@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cstring>
+#include <glue/network/simulated_link.hpp>
+
+namespace glue::network {
+void SimulatedLink::Endpoint::send(const IPv4Address& address,
+                                   std::span<u8> data) {
+  link_->sent_count_++;
+  if (address != peer_->address_) {
+    link_->dropped_count_++;
+    return;
+  }
+  link_->transmit(*this, data);
+}
+
+std::optional<u32> SimulatedLink::Endpoint::receive(std::span<u8> data,
+                                                    IPv4Address& sender) {
+  while (!incoming_.empty() && incoming_.top().arrival <= link_->now_) {
+    const auto& datagram = incoming_.top();
+    if (datagram.data.size() > data.size()) {
+      incoming_.pop();
+      continue;
+    }
+
+    const auto size = datagram.data.size();
+    std::memcpy(data.data(), datagram.data.data(), size);
+    sender = peer_->address_;
+    incoming_.pop();
+    return static_cast<u32>(size);
+  }
+  return std::nullopt;
+}
+
+bool SimulatedLink::Endpoint::receive(Packet& packet, IPv4Address& sender) {
+  const auto received_bytes = receive(packet.as_span(), sender);
+  return received_bytes && packet.finish_receive(*received_bytes);
+}
+
+std::size_t SimulatedLink::Endpoint::send_batch(
+    std::span<const Datagram> datagrams) {
+  for (const auto& datagram : datagrams) {
+    send(datagram.address, datagram.data);
+  }
+  return datagrams.size();
+}
+
+std::size_t SimulatedLink::Endpoint::receive_batch(
+    std::span<Datagram> datagrams) {
+  std::size_t received = 0;
+  for (auto& datagram : datagrams) {
+    const auto size = receive(datagram.data, datagram.address);
+    if (!size) {
+      break;
+    }
+    datagram.size = *size;
+    received++;
+  }
+  return received;
+}
+
+SimulatedLink::SimulatedLink(IPv4Address a, IPv4Address b,
+                             LinkConditions conditions, u32 seed)
+    : rng_{seed}, a_{*this, a, conditions}, b_{*this, b, conditions} {
+  a_.peer_ = &b_;
+  b_.peer_ = &a_;
+}
+
+void SimulatedLink::transmit(Endpoint& from, std::span<const u8> data) {
+  const auto& conditions = from.conditions_;
+
+  // bandwidth: wait for the wire, then occupy it for the datagram's length
+  auto departure = now_;
+  if (conditions.bandwidth_bytes_per_sec > 0) {
+    departure = std::max(now_, from.wire_free_at_);
+    const auto transmit_ns =
+        data.size() * 1'000'000'000ull / conditions.bandwidth_bytes_per_sec;
+    from.wire_free_at_ = departure + std::chrono::nanoseconds{transmit_ns};
+    departure = from.wire_free_at_;
+  }
+
+  if (roll(conditions.loss)) {
+    dropped_count_++;
+    return;
+  }
+
+  const u32 copies = roll(conditions.duplicate) ? 2 : 1;
+  for (u32 i = 0; i < copies; ++i) {
+    auto arrival =
+        departure + conditions.latency + random_duration(conditions.jitter);
+    if (roll(conditions.reorder)) {
+      arrival += conditions.reorder_delay;
+    }
+    from.peer_->incoming_.push(
+        {arrival, next_sequence_++, {data.begin(), data.end()}});
+  }
+}
+
+/*
+ * mt19937_64's output is fixed by the standard, but what the <random>
+ * distributions make of it isn't, so draws are derived from it directly
+ * to replay the same on every standard library.
+ */
+f64 SimulatedLink::uniform() noexcept {
+  // top 53 bits, as many as a double holds exactly, into [0, 1)
+  return static_cast<f64>(rng_() >> 11) * 0x1p-53;
+}
+
+bool SimulatedLink::roll(f64 chance) noexcept {
+  // don't draw for features that are off, so enabling one doesn't change
+  // what the others decide
+  if (chance <= 0.0) {
+    return false;
+  }
+  return uniform() < chance;
+}
+
+SimulatedLink::Clock::duration SimulatedLink::random_duration(
+    Clock::duration max) noexcept {
+  if (max <= Clock::duration::zero()) {
+    return Clock::duration::zero();
+  }
+  const auto ticks = static_cast<Clock::rep>(
+      uniform() * static_cast<f64>(max.count() + 1));
+  return Clock::duration{std::min(ticks, max.count())};
+}
+}  // namespace glue::network
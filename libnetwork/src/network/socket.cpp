@@ -1,15 +1,34 @@
 #include <fcntl.h>
 #include <glog/logging.h>
 #include <netinet/in.h>
+#include <netinet/udp.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
 #include <glue/assert.hpp>
 #include <glue/network/socket.hpp>
 
 // WINDOWS: initialize socket layer once, globally
 
 namespace glue::network {
+namespace {
+sockaddr_in to_sockaddr(const IPv4Address& address) noexcept {
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(address.ip());
+  addr.sin_port = htons(address.port());
+  return addr;
+}
+
+IPv4Address from_sockaddr(const sockaddr_in& addr) noexcept {
+  return IPv4Address{ntohl(addr.sin_addr.s_addr), ntohs(addr.sin_port)};
+}
+}  // namespace
+
 Socket::~Socket() {
   if (handle_) {
     shutdown(handle_, SHUT_RDWR);
@@ -17,13 +36,26 @@ Socket::~Socket() {
   }
 }
 
-std::optional<Socket> Socket::open(u16 port) {
+std::optional<Socket> Socket::open(u16 port, bool reuse_port) {
   Socket out{socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP), port};
   if (out.handle_ <= 0) {
     LOG(ERROR) << "Failed to open UDP socket for port " << port;
     return std::nullopt;
   }
 
+  /*
+   * Lets several sockets bind the same port, the kernel hashes each sender
+   * to one of them. Has to be set before bind().
+   */
+  if (reuse_port) {
+    const i32 enable = 1;
+    if (setsockopt(out.handle_, SOL_SOCKET, SO_REUSEPORT, &enable,
+                   sizeof(enable)) != 0) {
+      LOG(ERROR) << "Failed to set SO_REUSEPORT on UDP port " << port;
+      return std::nullopt;
+    }
+  }
+
   /*
    * sockaddr in socket.h is a generic base for all socket types
    *
@@ -63,58 +95,366 @@ std::optional<Socket> Socket::open(u16 port) {
 
 std::optional<Socket> Socket::open_any_port() {
   auto maybe_socket = Socket::open(0);
-  if (!maybe_socket.has_value()) {
+  if (!maybe_socket.has_value() || !maybe_socket->fill_port()) {
     return std::nullopt;
   }
+  return maybe_socket;
+}
+
+std::optional<std::vector<Socket>> Socket::open_shards(u16 port,
+                                                       std::size_t count) {
+  glue_assert(count > 0);
+  std::vector<Socket> shards;
+  shards.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    auto maybe_socket = Socket::open(port, true);
+    if (!maybe_socket.has_value()) {
+      return std::nullopt;
+    }
+
+    // the rest join whichever port the first one got
+    if (port == 0) {
+      if (!maybe_socket->fill_port()) {
+        return std::nullopt;
+      }
+      port = maybe_socket->port();
+    }
+    shards.push_back(std::move(*maybe_socket));
+  }
+  return shards;
+}
 
-  // fill in Socket::port
+bool Socket::fill_port() {
   sockaddr_in addr{};
   u32 addr_length = sizeof(addr);
-  auto get_name_status = getsockname(
-      maybe_socket->handle_, reinterpret_cast<sockaddr*>(&addr), &addr_length);
+  auto get_name_status =
+      getsockname(handle_, reinterpret_cast<sockaddr*>(&addr), &addr_length);
   if (get_name_status != 0) {
     LOG(ERROR) << "Failed to retrieve UDP port from socket";
-    return std::nullopt;
+    return false;
   }
   glue_assert(addr_length == sizeof(addr));
-  const u16 port = ntohs(addr.sin_port);
-  maybe_socket->port_ = port;
-
-  return maybe_socket;
+  port_ = ntohs(addr.sin_port);
+  return true;
 }
 
 void Socket::send(const IPv4Address& address, std::span<u8> data) {
-  sockaddr_in addr{};
-  addr.sin_family = AF_INET;
-  addr.sin_addr.s_addr = htonl(address.ip());
-  addr.sin_port = htons(address.port());
-
+  sockaddr_in addr = to_sockaddr(address);
   const auto sent_bytes =
       sendto(handle_, reinterpret_cast<const char*>(data.data()),
              static_cast<int>(data.size()), 0,
              reinterpret_cast<sockaddr*>(&addr), sizeof(sockaddr_in));
   if (sent_bytes != data.size()) {
+    if (telemetry_ != nullptr) {
+      telemetry_->record_send_failure();
+    }
     // PERF: structured logging or no logging at all
     LOG(ERROR) << "failed to send packet";
+  } else if (telemetry_ != nullptr) {
+    telemetry_->record_sent(static_cast<u32>(data.size()));
   }
 }
 
-bool Socket::receive(std::span<u8> data, IPv4Address& sender) {
+/*
+ * With MSG_TRUNC, Linux returns a UDP datagram's full size even when it
+ * didn't fit, which is how oversized datagrams are told apart and skipped.
+ * WINDOWS: fails with WSAEMSGSIZE instead
+ */
+std::optional<u32> Socket::receive(std::span<u8> data,
+                                   IPv4Address& sender) {
   sockaddr_in sender_addr{};
-  u32 sender_addr_length = sizeof(sender_addr);
-  const auto received_bytes =
-      recvfrom(handle_, reinterpret_cast<char*>(data.data()),
-               static_cast<int>(data.size()), 0,
-               reinterpret_cast<sockaddr*>(&sender_addr), &sender_addr_length);
+  ssize_t received_bytes = 0;
+  do {
+    u32 sender_addr_length = sizeof(sender_addr);
+    received_bytes = recvfrom(
+        handle_, reinterpret_cast<char*>(data.data()),
+        static_cast<int>(data.size()), MSG_TRUNC,
+        reinterpret_cast<sockaddr*>(&sender_addr), &sender_addr_length);
+  } while (received_bytes > static_cast<ssize_t>(data.size()));
 
-  if (received_bytes <= 0) {
-    return false;
+  if (received_bytes < 0) {
+    return std::nullopt;
+  }
+  if (telemetry_ != nullptr) {
+    telemetry_->record_received(static_cast<u32>(received_bytes));
   }
 
-  const u32 sender_ip = ntohl(sender_addr.sin_addr.s_addr);
-  const u16 sender_port = ntohs(sender_addr.sin_port);
-  sender = IPv4Address{sender_ip, sender_port};
+  sender = from_sockaddr(sender_addr);
+  return static_cast<u32>(received_bytes);
+}
+
+bool Socket::receive(Packet& packet, IPv4Address& sender) {
+  const auto received_bytes = receive(packet.as_span(), sender);
+  return received_bytes && packet.finish_receive(*received_bytes);
+}
 
+bool Socket::connect(const IPv4Address& peer) {
+  const sockaddr_in addr = to_sockaddr(peer);
+  if (::connect(handle_, reinterpret_cast<const sockaddr*>(&addr),
+                sizeof(addr)) != 0) {
+    LOG(ERROR) << "Failed to connect UDP socket on port " << port_;
+    return false;
+  }
+  connected_ = true;
+  peer_ = peer;
   return true;
 }
-}  // namespace glue::network
\ No newline at end of file
+
+void Socket::send(std::span<u8> data) {
+  glue_assert(connected_);
+  const auto sent_bytes =
+      ::send(handle_, reinterpret_cast<const char*>(data.data()),
+             static_cast<int>(data.size()), 0);
+  if (sent_bytes < 0 || static_cast<std::size_t>(sent_bytes) != data.size()) {
+    if (telemetry_ != nullptr) {
+      telemetry_->record_send_failure();
+    }
+    // PERF: structured logging or no logging at all
+    LOG(ERROR) << "failed to send packet";
+  } else if (telemetry_ != nullptr) {
+    telemetry_->record_sent(static_cast<u32>(data.size()));
+  }
+}
+
+std::optional<u32> Socket::receive(std::span<u8> data) {
+  glue_assert(connected_);
+  ssize_t received_bytes = 0;
+  do {
+    received_bytes = recv(handle_, reinterpret_cast<char*>(data.data()),
+                          static_cast<int>(data.size()), MSG_TRUNC);
+  } while (received_bytes > static_cast<ssize_t>(data.size()));
+
+  if (received_bytes < 0) {
+    return std::nullopt;
+  }
+  if (telemetry_ != nullptr) {
+    telemetry_->record_received(static_cast<u32>(received_bytes));
+  }
+  return static_cast<u32>(received_bytes);
+}
+
+bool Socket::receive(Packet& packet) {
+  const auto received_bytes = receive(packet.as_span());
+  return received_bytes && packet.finish_receive(*received_bytes);
+}
+
+/*
+ * sendmmsg / recvmmsg are Linux only.
+ * WINDOWS: loop over send() / receive() instead
+ */
+std::size_t Socket::send_batch(std::span<const Datagram> datagrams) {
+  std::array<mmsghdr, kMaxBatchSize> headers;
+  std::array<iovec, kMaxBatchSize> buffers;
+  std::array<sockaddr_in, kMaxBatchSize> addresses;
+
+  std::size_t sent = 0;
+  while (sent < datagrams.size()) {
+    const auto batch = datagrams.subspan(sent).first(
+        std::min(kMaxBatchSize, datagrams.size() - sent));
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+      addresses[i] = to_sockaddr(batch[i].address);
+      buffers[i] = {batch[i].data.data(), batch[i].data.size()};
+      headers[i] = {};
+      headers[i].msg_hdr.msg_name = &addresses[i];
+      headers[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+      headers[i].msg_hdr.msg_iov = &buffers[i];
+      headers[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    const int batch_sent =
+        sendmmsg(handle_, headers.data(), static_cast<u32>(batch.size()), 0);
+    if (batch_sent <= 0) {
+      // PERF: structured logging or no logging at all
+      LOG(ERROR) << "failed to send packet batch";
+      break;
+    }
+    if (telemetry_ != nullptr) {
+      for (int i = 0; i < batch_sent; ++i) {
+        telemetry_->record_sent(static_cast<u32>(batch[i].data.size()));
+      }
+    }
+    sent += batch_sent;
+  }
+
+  if (telemetry_ != nullptr && sent < datagrams.size()) {
+    telemetry_->record_send_failure(datagrams.size() - sent);
+  }
+  return sent;
+}
+
+std::size_t Socket::receive_batch(std::span<Datagram> datagrams) {
+  std::array<mmsghdr, kMaxBatchSize> headers;
+  std::array<iovec, kMaxBatchSize> buffers;
+  std::array<sockaddr_in, kMaxBatchSize> addresses;
+
+  std::size_t received = 0;
+  while (received < datagrams.size()) {
+    const auto batch = datagrams.subspan(received).first(
+        std::min(kMaxBatchSize, datagrams.size() - received));
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+      buffers[i] = {batch[i].data.data(), batch[i].data.size()};
+      headers[i] = {};
+      headers[i].msg_hdr.msg_name = &addresses[i];
+      headers[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+      headers[i].msg_hdr.msg_iov = &buffers[i];
+      headers[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    const int batch_received = recvmmsg(
+        handle_, headers.data(), static_cast<u32>(batch.size()), 0, nullptr);
+    if (batch_received <= 0) {
+      break;
+    }
+
+    // oversized datagrams are dropped, the rest move up over them
+    std::size_t kept = 0;
+    for (int i = 0; i < batch_received; ++i) {
+      if ((headers[i].msg_hdr.msg_flags & MSG_TRUNC) != 0) {
+        continue;
+      }
+      std::swap(batch[kept].data, batch[i].data);
+      batch[kept].size = headers[i].msg_len;
+      batch[kept].address = from_sockaddr(addresses[i]);
+      if (telemetry_ != nullptr) {
+        telemetry_->record_received(batch[kept].size);
+      }
+      ++kept;
+    }
+    received += kept;
+
+    // nothing more waiting
+    if (static_cast<std::size_t>(batch_received) < batch.size()) {
+      break;
+    }
+  }
+  return received;
+}
+
+/*
+ * UDP_SEGMENT is Linux 4.18+, UDP_GRO 5.0+.
+ * WINDOWS: USO / URO through WSASetUdpSendMessageSize, or always fall back
+ */
+bool Socket::enable_gso() {
+  // a zero default segment size is a no-op that fails without support
+  const i32 disabled = 0;
+  gso_ = setsockopt(handle_, SOL_UDP, UDP_SEGMENT, &disabled,
+                    sizeof(disabled)) == 0;
+  return gso_;
+}
+
+bool Socket::enable_gro() {
+  const i32 enable = 1;
+  gro_ =
+      setsockopt(handle_, SOL_UDP, UDP_GRO, &enable, sizeof(enable)) == 0;
+  return gro_;
+}
+
+std::size_t Socket::send_segments(const IPv4Address& address,
+                                  std::span<u8> data, u16 segment_size) {
+  glue_assert(segment_size > 0);
+  glue_assert(data.size() <= kMaxSegmentedBytes);
+  const std::size_t count = (data.size() + segment_size - 1) / segment_size;
+  glue_assert(count <= kMaxSegments);
+
+  if (gso_ && count > 1) {
+    sockaddr_in addr = to_sockaddr(address);
+    iovec buffer{data.data(), data.size()};
+    alignas(cmsghdr) std::array<u8, CMSG_SPACE(sizeof(u16))> control{};
+
+    msghdr message{};
+    message.msg_name = &addr;
+    message.msg_namelen = sizeof(addr);
+    message.msg_iov = &buffer;
+    message.msg_iovlen = 1;
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+
+    cmsghdr* header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_UDP;
+    header->cmsg_type = UDP_SEGMENT;
+    header->cmsg_len = CMSG_LEN(sizeof(u16));
+    std::memcpy(CMSG_DATA(header), &segment_size, sizeof(segment_size));
+
+    const auto sent_bytes = sendmsg(handle_, &message, 0);
+    if (sent_bytes == static_cast<ssize_t>(data.size())) {
+      if (telemetry_ != nullptr) {
+        telemetry_->record_sent(segment_size, count - 1);
+        telemetry_->record_sent(
+            static_cast<u32>(data.size() - (count - 1) * segment_size));
+      }
+      return count;
+    }
+
+    // EIO when the device can't checksum segments, which won't change
+    if (errno != EIO) {
+      if (telemetry_ != nullptr) {
+        telemetry_->record_send_failure(count);
+      }
+      // PERF: structured logging or no logging at all
+      LOG(ERROR) << "failed to send segmented packets";
+      return 0;
+    }
+    LOG(WARNING) << "UDP GSO unsupported by device, falling back";
+    gso_ = false;
+  }
+
+  std::array<Datagram, kMaxSegments> datagrams;
+  for (std::size_t i = 0; i < count; ++i) {
+    const std::size_t offset = i * segment_size;
+    const std::size_t size = std::min<std::size_t>(segment_size,
+                                                   data.size() - offset);
+    datagrams[i] = {data.subspan(offset, size), 0, address};
+  }
+  return send_batch(std::span{datagrams}.first(count));
+}
+
+std::optional<u32> Socket::receive_segments(std::span<u8> data,
+                                            IPv4Address& sender,
+                                            u16& segment_size) {
+  sockaddr_in addr{};
+  iovec buffer{data.data(), data.size()};
+  alignas(cmsghdr) std::array<u8, CMSG_SPACE(sizeof(i32))> control{};
+
+  msghdr message{};
+  message.msg_name = &addr;
+  message.msg_namelen = sizeof(addr);
+  message.msg_iov = &buffer;
+  message.msg_iovlen = 1;
+  message.msg_control = control.data();
+  message.msg_controllen = control.size();
+
+  ssize_t received_bytes = 0;
+  do {
+    message.msg_controllen = control.size();
+    received_bytes = recvmsg(handle_, &message, 0);
+  } while (received_bytes >= 0 && (message.msg_flags & MSG_TRUNC) != 0);
+
+  if (received_bytes < 0) {
+    return std::nullopt;
+  }
+
+  // no UDP_GRO message means a single datagram
+  segment_size = static_cast<u16>(received_bytes);
+  for (cmsghdr* header = CMSG_FIRSTHDR(&message); header != nullptr;
+       header = CMSG_NXTHDR(&message, header)) {
+    if (header->cmsg_level == SOL_UDP && header->cmsg_type == UDP_GRO) {
+      i32 size = 0;
+      std::memcpy(&size, CMSG_DATA(header), sizeof(size));
+      segment_size = static_cast<u16>(size);
+    }
+  }
+
+  if (telemetry_ != nullptr) {
+    const auto total = static_cast<u32>(received_bytes);
+    if (total == 0 || total % segment_size != 0) {
+      telemetry_->record_received(total == 0 ? 0 : total % segment_size);
+    }
+    if (total >= segment_size && segment_size > 0) {
+      telemetry_->record_received(segment_size, total / segment_size);
+    }
+  }
+
+  sender = from_sockaddr(addr);
+  return static_cast<u32>(received_bytes);
+}
+}  // namespace glue::network
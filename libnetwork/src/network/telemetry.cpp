@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cmath>
+#include <glue/network/telemetry.hpp>
+
+namespace glue::network {
+namespace {
+constexpr auto kRelaxed = std::memory_order_relaxed;
+}  // namespace
+
+u64 Histogram::Snapshot::total() const noexcept {
+  u64 total = 0;
+  for (const u64 count : counts) {
+    total += count;
+  }
+  return total;
+}
+
+f64 Histogram::Snapshot::percentile(f64 fraction) const noexcept {
+  const u64 samples = total();
+  if (samples == 0) {
+    return 0.0;
+  }
+
+  // the rank'th sample, counting from 1
+  const auto rank = std::max<u64>(
+      1, static_cast<u64>(std::ceil(std::clamp(fraction, 0.0, 1.0) *
+                                    static_cast<f64>(samples))));
+  u64 seen = 0;
+  for (std::size_t i = 0; i < bounds.size(); ++i) {
+    seen += counts[i];
+    if (seen >= rank) {
+      return bounds[i];
+    }
+  }
+  return bounds.back();
+}
+
+void Histogram::record(f64 value, u64 count) noexcept {
+  const auto bucket = std::lower_bound(bounds_.begin(), bounds_.end(), value) -
+                      bounds_.begin();
+  counts_[bucket].fetch_add(count, kRelaxed);
+}
+
+Histogram::Snapshot Histogram::snapshot() const noexcept {
+  Snapshot out;
+  out.bounds = bounds_;
+  for (std::size_t i = 0; i < kBuckets; ++i) {
+    out.counts[i] = counts_[i].load(kRelaxed);
+  }
+  return out;
+}
+
+void SocketTelemetry::record_sent(u32 bytes, u64 count) noexcept {
+  packets_sent_.fetch_add(count, kRelaxed);
+  bytes_sent_.fetch_add(bytes * count, kRelaxed);
+  sent_sizes_.record(bytes, count);
+}
+
+void SocketTelemetry::record_received(u32 bytes, u64 count) noexcept {
+  packets_received_.fetch_add(count, kRelaxed);
+  bytes_received_.fetch_add(bytes * count, kRelaxed);
+  received_sizes_.record(bytes, count);
+}
+
+void SocketTelemetry::record_send_failure(u64 count) noexcept {
+  send_failures_.fetch_add(count, kRelaxed);
+}
+
+SocketStats SocketTelemetry::snapshot() const noexcept {
+  SocketStats out;
+  out.packets_sent = packets_sent_.load(kRelaxed);
+  out.bytes_sent = bytes_sent_.load(kRelaxed);
+  out.packets_received = packets_received_.load(kRelaxed);
+  out.bytes_received = bytes_received_.load(kRelaxed);
+  out.send_failures = send_failures_.load(kRelaxed);
+  out.sent_sizes = sent_sizes_.snapshot();
+  out.received_sizes = received_sizes_.snapshot();
+  return out;
+}
+
+void ConnectionTelemetry::record_payload_sent(u32 bytes) noexcept {
+  bytes_sent_.fetch_add(bytes, kRelaxed);
+  sent_sizes_.record(bytes);
+}
+
+void ConnectionTelemetry::record_payload_received(u32 bytes) noexcept {
+  bytes_received_.fetch_add(bytes, kRelaxed);
+  received_sizes_.record(bytes);
+}
+
+void ConnectionTelemetry::record_packet_sent() noexcept {
+  packets_sent_.fetch_add(1, kRelaxed);
+}
+
+void ConnectionTelemetry::record_packet_received() noexcept {
+  packets_received_.fetch_add(1, kRelaxed);
+}
+
+void ConnectionTelemetry::record_packet_rejected() noexcept {
+  packets_rejected_.fetch_add(1, kRelaxed);
+}
+
+void ConnectionTelemetry::record_packet_acked() noexcept {
+  packets_acked_.fetch_add(1, kRelaxed);
+}
+
+void ConnectionTelemetry::record_packet_lost() noexcept {
+  packets_lost_.fetch_add(1, kRelaxed);
+}
+
+void ConnectionTelemetry::record_rtt_sample(f64 sample, f64 rtt,
+                                            f64 jitter) noexcept {
+  rtt_samples_.record(sample);
+  rtt_.store(rtt, kRelaxed);
+  jitter_.store(jitter, kRelaxed);
+}
+
+void ConnectionTelemetry::set_packet_loss(f64 packet_loss) noexcept {
+  packet_loss_.store(packet_loss, kRelaxed);
+}
+
+ConnectionStats ConnectionTelemetry::snapshot() const noexcept {
+  ConnectionStats out;
+  out.packets_sent = packets_sent_.load(kRelaxed);
+  out.packets_received = packets_received_.load(kRelaxed);
+  out.packets_acked = packets_acked_.load(kRelaxed);
+  out.packets_lost = packets_lost_.load(kRelaxed);
+  out.packets_rejected = packets_rejected_.load(kRelaxed);
+  out.bytes_sent = bytes_sent_.load(kRelaxed);
+  out.bytes_received = bytes_received_.load(kRelaxed);
+  out.packet_loss = packet_loss_.load(kRelaxed);
+  out.rtt = rtt_.load(kRelaxed);
+  out.jitter = jitter_.load(kRelaxed);
+  out.rtt_samples = rtt_samples_.snapshot();
+  out.sent_sizes = sent_sizes_.snapshot();
+  out.received_sizes = received_sizes_.snapshot();
+  return out;
+}
+}  // namespace glue::network
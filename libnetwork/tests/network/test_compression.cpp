@@ -0,0 +1,176 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <glue/network/compression.hpp>
+#include <glue/network/cube_state.hpp>
+#include <random>
+#include <vector>
+
+using namespace glue;
+using namespace glue::network;
+
+namespace {
+/*
+ * count cubes at rest, packed as a join snapshot would carry them. They're
+ * from further into the grid than the default dictionary covers.
+ */
+std::vector<u8> resting_cubes(u16 count) {
+  std::vector<u32> words(PayloadCompressor::kMaxPayloadBytes / 4);
+  bitpack::Packer packer{words};
+  for (u16 i = 0; i < count; ++i) {
+    auto cube = resting_cube(451 + i);
+    pack(packer, cube);
+  }
+
+  const auto* bytes = reinterpret_cast<const u8*>(words.data());
+  return {bytes, bytes + (packer.current_bit() + 7) / 8};
+}
+
+std::vector<u8> random_bytes(std::size_t count) {
+  std::mt19937 rng{1};
+  std::vector<u8> out(count);
+  for (auto& byte : out) {
+    byte = static_cast<u8>(rng());
+  }
+  return out;
+}
+
+std::vector<u8> round_trip(PayloadCompressor& sender,
+                           PayloadCompressor& receiver,
+                           std::span<const u8> payload) {
+  std::vector<u32> datagram(400);
+  bitpack::Packer packer{datagram};
+  sender.write(packer, payload);
+
+  bitpack::CheckedUnpacker unpacker{datagram};
+  const auto received = receiver.read(unpacker);
+  EXPECT_FALSE(unpacker.overflowed());
+  if (!received) {
+    ADD_FAILURE() << "read failed";
+    return {};
+  }
+  return {received->begin(), received->end()};
+}
+
+bool written_compressed(PayloadCompressor& sender,
+                        std::span<const u8> payload) {
+  std::vector<u32> datagram(400);
+  bitpack::Packer packer{datagram};
+  sender.write(packer, payload);
+  bitpack::Unpacker unpacker{datagram};
+  return unpacker.read_bits(1) == 1;
+}
+}  // namespace
+
+TEST(CompressionTests, StructuredPayloadShrinksAndRoundTrips) {
+  auto sender = PayloadCompressor::create();
+  auto receiver = PayloadCompressor::create();
+  ASSERT_TRUE(sender && receiver);
+
+  const auto payload = resting_cubes(30);
+  EXPECT_EQ(round_trip(*sender, *receiver, payload), payload);
+
+  const auto& stats = sender->stats();
+  EXPECT_EQ(stats.attempted, 1);
+  EXPECT_EQ(stats.compressed, 1);
+  EXPECT_LT(stats.ratio(), 0.75);
+  EXPECT_GT(stats.compress_us_per_payload(), 0.0);
+  EXPECT_EQ(receiver->stats().decompressed, 1);
+}
+
+TEST(CompressionTests, DictionaryHelpsSmallPayloads) {
+  auto with_dictionary = PayloadCompressor::create();
+  auto without_dictionary = PayloadCompressor::create({});
+  ASSERT_TRUE(with_dictionary && without_dictionary);
+
+  const auto payload = resting_cubes(4);
+  std::array<u8, PayloadCompressor::kMaxPayloadBytes> out;
+  const auto with = with_dictionary->compress(payload, out);
+  const auto without = without_dictionary->compress(payload, out);
+  ASSERT_TRUE(with.has_value());
+  EXPECT_LT(*with, without.value_or(payload.size()));
+}
+
+TEST(CompressionTests, SmallPayloadsSentRaw) {
+  auto sender = PayloadCompressor::create();
+  auto receiver = PayloadCompressor::create();
+  ASSERT_TRUE(sender && receiver);
+
+  const auto payload = resting_cubes(2);
+  ASSERT_LT(payload.size(), PayloadCompressor::kMinCompressBytes);
+  EXPECT_FALSE(written_compressed(*sender, payload));
+  EXPECT_EQ(round_trip(*sender, *receiver, payload), payload);
+  EXPECT_EQ(sender->stats().attempted, 0);
+}
+
+TEST(CompressionTests, IncompressiblePayloadsSentRaw) {
+  auto sender = PayloadCompressor::create();
+  auto receiver = PayloadCompressor::create();
+  ASSERT_TRUE(sender && receiver);
+
+  const auto payload = random_bytes(500);
+  EXPECT_FALSE(written_compressed(*sender, payload));
+  EXPECT_EQ(round_trip(*sender, *receiver, payload), payload);
+  EXPECT_EQ(sender->stats().compressed, 0);
+  EXPECT_DOUBLE_EQ(sender->stats().ratio(), 1.0);
+}
+
+TEST(CompressionTests, StreamsReusedAcrossManyPayloads) {
+  auto sender = PayloadCompressor::create();
+  auto receiver = PayloadCompressor::create();
+  ASSERT_TRUE(sender && receiver);
+
+  for (u16 count = 6; count < 40; ++count) {
+    const auto payload = resting_cubes(count);
+    ASSERT_EQ(round_trip(*sender, *receiver, payload), payload);
+  }
+  EXPECT_EQ(sender->stats().attempted, 34);
+}
+
+TEST(CompressionTests, CorruptDataRejected) {
+  auto compressor = PayloadCompressor::create();
+  ASSERT_TRUE(compressor);
+
+  const auto payload = resting_cubes(30);
+  std::array<u8, PayloadCompressor::kMaxPayloadBytes> compressed;
+  const auto size = compressor->compress(payload, compressed);
+  ASSERT_TRUE(size.has_value());
+
+  std::array<u8, PayloadCompressor::kMaxPayloadBytes> out;
+  EXPECT_FALSE(
+      compressor->decompress(std::span{compressed}.first(*size / 2), out));
+
+  // too small for the payload
+  EXPECT_FALSE(compressor->decompress(std::span{compressed}.first(*size),
+                                      std::span{out}.first(100)));
+}
+
+TEST(CompressionTests, MismatchedDictionaryFails) {
+  auto sender = PayloadCompressor::create();
+  const std::array<u8, 4> other_dictionary{1, 2, 3, 4};
+  auto receiver = PayloadCompressor::create(other_dictionary);
+  ASSERT_TRUE(sender && receiver);
+
+  const auto payload = resting_cubes(30);
+  std::array<u8, PayloadCompressor::kMaxPayloadBytes> compressed;
+  const auto size = sender->compress(payload, compressed);
+  ASSERT_TRUE(size.has_value());
+
+  std::array<u8, PayloadCompressor::kMaxPayloadBytes> out;
+  const auto received =
+      receiver->decompress(std::span{compressed}.first(*size), out);
+  EXPECT_TRUE(!received ||
+              !std::equal(payload.begin(), payload.end(), out.begin()));
+}
+
+TEST(CompressionTests, MovedCompressorStillWorks) {
+  auto created = PayloadCompressor::create();
+  ASSERT_TRUE(created);
+  PayloadCompressor sender = std::move(*created);
+  auto receiver = PayloadCompressor::create();
+  ASSERT_TRUE(receiver);
+
+  const auto payload = resting_cubes(20);
+  EXPECT_EQ(round_trip(sender, *receiver, payload), payload);
+}
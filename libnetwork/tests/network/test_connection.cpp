@@ -0,0 +1,246 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <glue/network/connection.hpp>
+#include <glue/types.hpp>
+#include <vector>
+
+using namespace glue;
+using namespace glue::network;
+using namespace std::chrono_literals;
+
+namespace {
+Connection::Clock::time_point at(std::chrono::milliseconds ms) {
+  return Connection::Clock::time_point{} + ms;
+}
+}  // namespace
+
+TEST(ConnectionTests, IndicesAreSequentialFromOne) {
+  Connection connection;
+  for (u32 i = 1; i <= 100; ++i) {
+    EXPECT_EQ(connection.next_header(at(0ms)).index, i);
+  }
+  EXPECT_EQ(connection.sent_count(), 100);
+}
+
+TEST(ConnectionTests, HeaderAcksReceivedPackets) {
+  Connection connection;
+  EXPECT_TRUE(connection.on_receive({1, 0, 0}, at(0ms)));
+  EXPECT_TRUE(connection.on_receive({2, 0, 0}, at(0ms)));
+  EXPECT_TRUE(connection.on_receive({4, 0, 0}, at(0ms)));
+
+  const auto header = connection.next_header(at(0ms));
+  EXPECT_EQ(header.receipt_index, 4);
+  // index 0 is never sent, the empty window counts it as present
+  EXPECT_EQ(header.receipt_flags, 0b1110);
+}
+
+TEST(ConnectionTests, DuplicateAndStalePacketsRejected) {
+  Connection connection;
+  EXPECT_TRUE(connection.on_receive({5, 0, 0}, at(0ms)));
+  EXPECT_FALSE(connection.on_receive({5, 0, 0}, at(0ms)));
+  EXPECT_TRUE(connection.on_receive({3, 0, 0}, at(0ms)));
+  EXPECT_FALSE(connection.on_receive({3, 0, 0}, at(0ms)));
+
+  EXPECT_TRUE(connection.on_receive({100, 0, 0}, at(0ms)));
+  EXPECT_FALSE(connection.on_receive({50, 0, 0}, at(0ms)));
+}
+
+TEST(ConnectionTests, FirstAckSetsRttAndJitter) {
+  Connection connection;
+  EXPECT_EQ(connection.rtt(), 0.0);
+
+  const auto sent = connection.next_header(at(1000ms));
+  connection.on_receive({1, sent.index, 0}, at(1100ms));
+
+  EXPECT_DOUBLE_EQ(connection.rtt(), 0.1);
+  EXPECT_DOUBLE_EQ(connection.jitter(), 0.05);
+  EXPECT_EQ(connection.acked_count(), 1);
+}
+
+TEST(ConnectionTests, RttConvergesToSteadyLatency) {
+  Connection connection;
+  for (u32 i = 0; i < 200; ++i) {
+    const auto sent_at = at(std::chrono::milliseconds{i * 16});
+    const auto sent = connection.next_header(sent_at);
+    connection.on_receive({i + 1, sent.index, 0xffffffff}, sent_at + 40ms);
+  }
+
+  EXPECT_NEAR(connection.rtt(), 0.04, 1e-6);
+  EXPECT_NEAR(connection.jitter(), 0.0, 1e-3);
+  EXPECT_NEAR(connection.packet_loss(), 0.0, 1e-9);
+}
+
+TEST(ConnectionTests, JitterTracksVaryingLatency) {
+  Connection connection;
+  for (u32 i = 0; i < 200; ++i) {
+    const auto sent_at = at(std::chrono::milliseconds{i * 16});
+    const auto latency = (i % 2 == 0) ? 30ms : 50ms;
+    const auto sent = connection.next_header(sent_at);
+    connection.on_receive({i + 1, sent.index, 0xffffffff}, sent_at + latency);
+  }
+
+  EXPECT_NEAR(connection.rtt(), 0.04, 2e-3);
+  EXPECT_NEAR(connection.jitter(), 0.01, 2e-3);
+}
+
+TEST(ConnectionTests, OnlyDirectAckGivesRttSample) {
+  Connection connection;
+  connection.next_header(at(0ms));
+  connection.next_header(at(100ms));
+
+  // packet 1 is acked late through the flags, packet 2 directly
+  connection.on_receive({1, 2, 0b1}, at(150ms));
+  EXPECT_DOUBLE_EQ(connection.rtt(), 0.05);
+  EXPECT_EQ(connection.acked_count(), 2);
+}
+
+TEST(ConnectionTests, RepeatedAcksCountedOnce) {
+  Connection connection;
+  const auto sent = connection.next_header(at(0ms));
+  connection.on_receive({1, sent.index, 0}, at(10ms));
+  connection.on_receive({2, sent.index, 0}, at(500ms));
+
+  EXPECT_EQ(connection.acked_count(), 1);
+  EXPECT_DOUBLE_EQ(connection.rtt(), 0.01);
+}
+
+TEST(ConnectionTests, PacketsLeavingAckWindowUnackedAreLost) {
+  Connection connection;
+  for (int i = 0; i < 40; ++i) {
+    connection.next_header(at(0ms));
+  }
+
+  // acks 40 only, 1..7 fall out of the window
+  connection.on_receive({1, 40, 0}, at(10ms));
+  EXPECT_EQ(connection.lost_count(), 7);
+  EXPECT_EQ(connection.acked_count(), 1);
+  EXPECT_GT(connection.packet_loss(), 0.0);
+}
+
+TEST(ConnectionTests, PacketLossEstimateMatchesDropRate) {
+  Connection connection;
+  u32 remote_index = 1;
+  PresenceWindow remote_received;
+
+  for (u32 i = 0; i < 2000; ++i) {
+    const auto now = at(std::chrono::milliseconds{i * 16});
+    const auto sent = connection.next_header(now);
+
+    // every 4th packet is dropped on the way
+    if (sent.index % 4 != 0) {
+      remote_received.mark(sent.index);
+    }
+    connection.on_receive({remote_index++, remote_received.latest(),
+                           remote_received.present_flags()},
+                          now + 20ms);
+  }
+
+  EXPECT_NEAR(connection.packet_loss(), 0.25, 0.1);
+  const f64 lost = static_cast<f64>(connection.lost_count());
+  EXPECT_NEAR(lost / (lost + connection.acked_count()), 0.25, 0.01);
+}
+
+TEST(ConnectionTests, PacketsNeverAckedLostWhenRingWraps) {
+  Connection connection;
+  for (u32 i = 0; i < Connection::kSentRingSize + 10; ++i) {
+    connection.next_header(at(0ms));
+  }
+  EXPECT_EQ(connection.lost_count(), 10);
+  EXPECT_EQ(connection.acked_count(), 0);
+}
+
+namespace {
+struct RecordingListener final : IPacketListener {
+  std::vector<u32> acked;
+  std::vector<u32> lost;
+
+  void on_packet_acked(u32 index) override { acked.push_back(index); }
+  void on_packet_lost(u32 index) override { lost.push_back(index); }
+};
+}  // namespace
+
+TEST(ConnectionTests, BurstLossOfWindowSizeNeverReportedAcked) {
+  Connection connection;
+  RecordingListener listener;
+  connection.set_listener(&listener);
+
+  // 11..41 are dropped, 42 lands exactly kWindowSize past 10
+  PresenceWindow remote_received;
+  for (u32 i = 1; i <= 42; ++i) {
+    const auto sent = connection.next_header(at(0ms));
+    if (sent.index <= 10 || sent.index == 42) {
+      remote_received.mark(sent.index);
+    }
+  }
+  connection.on_receive(
+      {1, remote_received.latest(), remote_received.present_flags()},
+      at(10ms));
+
+  for (u32 index : listener.acked) {
+    EXPECT_TRUE(index == 10 || index == 42) << index;
+  }
+  EXPECT_EQ(connection.acked_count(), 2);
+  EXPECT_EQ(connection.lost_count(), 9);
+}
+
+namespace {
+// what's left of a header after the wire, see PacketHeader
+PacketHeader over_wire(const PacketHeader& header) {
+  return {header.index & 0xffff, header.receipt_index & 0xffff,
+          header.receipt_flags};
+}
+}  // namespace
+
+TEST(ConnectionTests, IndicesKeepCountingPastSequenceWrap) {
+  constexpr u32 kPackets = 3 * 65536 + 100;
+  Connection a;
+  Connection b;
+
+  for (u32 i = 0; i < kPackets; ++i) {
+    const auto now = at(std::chrono::milliseconds{i});
+    const auto from_a = a.next_header(now);
+    const auto from_b = b.next_header(now);
+
+    // every 10th packet from a is dropped
+    if (from_a.index % 10 != 0) {
+      EXPECT_TRUE(b.on_receive(over_wire(from_a), now));
+    }
+    EXPECT_TRUE(a.on_receive(over_wire(from_b), now));
+  }
+
+  EXPECT_EQ(b.received().latest(), kPackets);
+  EXPECT_EQ(a.received().latest(), kPackets);
+  EXPECT_NEAR(a.packet_loss(), 0.1, 0.05);
+  EXPECT_NEAR(b.packet_loss(), 0.0, 1e-9);
+  EXPECT_EQ(a.lost_count(), (kPackets - 33) / 10);
+}
+
+TEST(ConnectionTests, StalePacketsRejectedAcrossSequenceWrap) {
+  Connection connection;
+  for (u32 index = 65530; index < 65540; ++index) {
+    EXPECT_TRUE(connection.on_receive(over_wire({index, 0, 0}), at(0ms)));
+  }
+  EXPECT_EQ(connection.received().latest(), 65539);
+
+  // 65535 was already received, 65500 is too old for the window
+  EXPECT_FALSE(connection.on_receive(over_wire({65535, 0, 0}), at(0ms)));
+  EXPECT_FALSE(connection.on_receive(over_wire({65500, 0, 0}), at(0ms)));
+  EXPECT_TRUE(connection.on_receive(over_wire({65541, 0, 0}), at(0ms)));
+}
+
+TEST(ConnectionTests, ReceiptAheadOfSentPacketsIgnored) {
+  Connection connection;
+  for (int i = 0; i < 40; ++i) {
+    connection.next_header(at(0ms));
+  }
+
+  // 41 was never sent
+  EXPECT_TRUE(connection.on_receive(over_wire({1, 41, ~0u}), at(10ms)));
+  EXPECT_EQ(connection.received().latest(), 1);
+  EXPECT_EQ(connection.acked_count(), 0);
+  EXPECT_EQ(connection.lost_count(), 0);
+
+  EXPECT_TRUE(connection.on_receive(over_wire({2, 40, ~0u}), at(10ms)));
+  EXPECT_GT(connection.acked_count(), 0);
+}
@@ -0,0 +1,225 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstring>
+#include <glue/debug/timer.hpp>
+#include <glue/network/event_loop.hpp>
+#include <glue/types.hpp>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace glue;
+using namespace glue::network;
+using namespace std::chrono_literals;
+
+TEST(EventLoopTests, GivenNoEvents_RunOnceTimesOut) {
+  auto loop = EventLoop::create();
+  ASSERT_TRUE(loop.has_value());
+
+  debug::Timer timer;
+  EXPECT_TRUE(loop->run_once(20ms));
+  EXPECT_GE(timer.elapsed_ms<f64>(), 15.0);
+}
+
+TEST(EventLoopTests, TimerFiresRepeatedly) {
+  auto loop = EventLoop::create();
+  ASSERT_TRUE(loop.has_value());
+
+  int fired = 0;
+  ASSERT_TRUE(loop->add_timer(5ms, [&] {
+    if (++fired == 3) {
+      loop->stop();
+    }
+  }));
+
+  debug::Timer timer;
+  loop->run();
+  EXPECT_EQ(fired, 3);
+  EXPECT_GE(timer.elapsed_ms<f64>(), 14.0);
+  EXPECT_FALSE(loop->run_once(0ms));
+}
+
+TEST(EventLoopTests, StopFromOtherThreadWakesBlockedLoop) {
+  auto loop = EventLoop::create();
+  ASSERT_TRUE(loop.has_value());
+
+  std::thread stopper{[&] {
+    std::this_thread::sleep_for(20ms);
+    loop->stop();
+  }};
+
+  debug::Timer timer;
+  loop->run();
+  stopper.join();
+  EXPECT_TRUE(loop->stopped());
+  EXPECT_LT(timer.elapsed_sec<f64>(), 1.0);
+}
+
+TEST(EventLoopTests, TimeoutTooLongForEpollWaitsForever) {
+  auto loop = EventLoop::create();
+  ASSERT_TRUE(loop.has_value());
+
+  std::thread stopper{[&] {
+    std::this_thread::sleep_for(20ms);
+    loop->stop();
+  }};
+
+  // 1ms if cut down to an i32
+  EXPECT_FALSE(loop->run_once(std::chrono::milliseconds{(1ll << 32) + 1}));
+  stopper.join();
+}
+
+TEST(EventLoopTests, FloodedSocketReadOneBatchPerWakeup) {
+  constexpr u32 kDatagrams = 2 * Socket::kMaxBatchSize + 10;
+
+  auto loop = EventLoop::create();
+  ASSERT_TRUE(loop.has_value());
+  auto server = Socket::open_any_port();
+  auto client = Socket::open_any_port();
+  ASSERT_TRUE(server.has_value() && client.has_value());
+
+  u32 received = 0;
+  ASSERT_TRUE(loop->add_socket(
+      *server, [&](Connection&, std::span<u8>) { ++received; }));
+
+  std::array<u8, 4> payload{};
+  for (u32 i = 0; i < kDatagrams; ++i) {
+    client->send(IPv4Address::loopback(server->port()), payload);
+  }
+
+  EXPECT_TRUE(loop->run_once(100ms));
+  EXPECT_LE(received, Socket::kMaxBatchSize);
+
+  // epoll keeps reporting the socket until it's empty
+  debug::Timer timer;
+  while (received < kDatagrams && timer.elapsed_sec<f64>() < 0.5) {
+    loop->run_once(5ms);
+  }
+  EXPECT_EQ(received, kDatagrams);
+}
+
+TEST(EventLoopTests, GivenManyClients_DatagramsDispatchedPerConnection) {
+  constexpr std::size_t kClients = 8;
+  constexpr u32 kPacketsPerClient = 100;
+
+  auto loop = EventLoop::create();
+  ASSERT_TRUE(loop.has_value());
+  auto server = Socket::open_any_port();
+  ASSERT_TRUE(server.has_value());
+  const auto server_address = IPv4Address::loopback(server->port());
+
+  std::vector<Socket> clients;
+  for (std::size_t i = 0; i < kClients; ++i) {
+    auto client = Socket::open_any_port();
+    ASSERT_TRUE(client.has_value());
+    clients.push_back(std::move(*client));
+  }
+
+  // each datagram is (client, sequence), check they land on the right
+  // Connection in order
+  std::unordered_map<Connection*, std::vector<u32>> received;
+  u32 total = 0;
+  bool wrong_sender = false;
+  ASSERT_TRUE(loop->add_socket(
+      *server, [&](Connection& connection, std::span<u8> data) {
+        ASSERT_EQ(data.size(), 2 * sizeof(u32));
+        u32 client = 0;
+        u32 sequence = 0;
+        std::memcpy(&client, data.data(), sizeof(u32));
+        std::memcpy(&sequence, data.data() + sizeof(u32), sizeof(u32));
+        if (connection.address().port() != clients[client].port()) {
+          wrong_sender = true;
+        }
+        received[&connection].push_back(sequence);
+        if (++total == kClients * kPacketsPerClient) {
+          loop->stop();
+        }
+      }));
+
+  // give up rather than hang if loopback drops something
+  ASSERT_TRUE(loop->add_timer(2s, [&] { loop->stop(); }));
+
+  std::thread sender{[&] {
+    for (u32 sequence = 0; sequence < kPacketsPerClient; ++sequence) {
+      for (u32 client = 0; client < kClients; ++client) {
+        std::array<u32, 2> payload{client, sequence};
+        clients[client].send(server_address,
+                             {reinterpret_cast<u8*>(payload.data()),
+                              sizeof(payload)});
+      }
+      if (sequence % 20 == 0) {
+        std::this_thread::sleep_for(1ms);
+      }
+    }
+  }};
+  loop->run();
+  sender.join();
+
+  EXPECT_FALSE(wrong_sender);
+  EXPECT_EQ(loop->connection_count(), kClients);
+  EXPECT_EQ(total, kClients * kPacketsPerClient);
+  for (const auto& client : clients) {
+    Connection* connection =
+        loop->find_connection(IPv4Address::loopback(client.port()));
+    ASSERT_NE(connection, nullptr);
+    const auto& sequences = received[connection];
+    ASSERT_EQ(sequences.size(), kPacketsPerClient);
+    for (u32 i = 0; i < kPacketsPerClient; ++i) {
+      EXPECT_EQ(sequences[i], i);
+    }
+  }
+}
+
+TEST(EventLoopTests, NewSendersPastConnectionCapRefusedUntilOthersExpire) {
+  auto loop = EventLoop::create();
+  ASSERT_TRUE(loop.has_value());
+  loop->set_connection_limits(2, 50ms);
+  auto server = Socket::open_any_port();
+  ASSERT_TRUE(server.has_value());
+  const auto server_address = IPv4Address::loopback(server->port());
+
+  std::vector<Socket> clients;
+  for (std::size_t i = 0; i < 3; ++i) {
+    auto client = Socket::open_any_port();
+    ASSERT_TRUE(client.has_value());
+    clients.push_back(std::move(*client));
+  }
+
+  std::vector<u16> senders;
+  ASSERT_TRUE(loop->add_socket(
+      *server, [&](Connection& connection, std::span<u8>) {
+        senders.push_back(connection.address().port());
+      }));
+
+  const auto send_from = [&](Socket& client) {
+    std::array<u8, 4> payload{};
+    client.send(server_address, payload);
+  };
+  const auto run_until = [&](auto done) {
+    debug::Timer timer;
+    while (!done() && timer.elapsed_sec<f64>() < 0.5) {
+      loop->run_once(5ms);
+    }
+  };
+
+  for (auto& client : clients) {
+    send_from(client);
+  }
+  run_until([&] { return senders.size() + loop->refused_count() == 3; });
+  EXPECT_EQ(senders.size(), 2);
+  EXPECT_EQ(loop->refused_count(), 1);
+  EXPECT_EQ(loop->connection_count(), 2);
+
+  // both go quiet and expire, making room for the third
+  run_until([&] { return loop->connection_count() == 0; });
+  EXPECT_EQ(loop->connection_count(), 0);
+
+  send_from(clients[2]);
+  run_until([&] { return senders.size() == 3; });
+  ASSERT_EQ(senders.size(), 3);
+  EXPECT_EQ(senders.back(), clients[2].port());
+  EXPECT_NE(loop->find_connection(IPv4Address::loopback(clients[2].port())),
+            nullptr);
+}
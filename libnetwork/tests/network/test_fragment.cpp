@@ -0,0 +1,187 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <glue/network/fragment.hpp>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace glue;
+using namespace glue::network;
+using namespace std::chrono_literals;
+
+namespace {
+using Datagram = std::vector<u32>;
+
+Reassembler::Clock::time_point at(std::chrono::milliseconds ms) {
+  return Reassembler::Clock::time_point{} + ms;
+}
+
+std::vector<u32> make_payload(std::size_t words, u32 seed) {
+  std::mt19937 rng{seed};
+  std::vector<u32> payload(words);
+  std::generate(payload.begin(), payload.end(), rng);
+  return payload;
+}
+
+/*
+ * Every fragment of payload, as Packet data would carry it.
+ */
+std::vector<Datagram> split(u16 group, const std::vector<u32>& payload) {
+  std::vector<Datagram> fragments;
+  for (u32 i = 0; i < fragment_count(payload.size()); ++i) {
+    Datagram& datagram = fragments.emplace_back(kFragmentDataSizeBytes / 4);
+    bitpack::Packer packer{datagram};
+    write_fragment(packer, group, payload, i);
+  }
+  return fragments;
+}
+
+std::optional<std::vector<u32>> read(Reassembler& reassembler,
+                                     Datagram& datagram,
+                                     Reassembler::Clock::time_point now) {
+  bitpack::CheckedUnpacker unpacker{datagram};
+  auto payload = reassembler.read(unpacker, now);
+  EXPECT_FALSE(unpacker.overflowed());
+  if (!payload) {
+    return std::nullopt;
+  }
+  return std::vector<u32>{payload->begin(), payload->end()};
+}
+}  // namespace
+
+TEST(FragmentTests, FragmentFitsInDatagram) {
+  EXPECT_LE(kFragmentDataSizeBytes, 1200);
+  EXPECT_EQ(fragment_count(0), 0);
+  EXPECT_EQ(fragment_count(1), 1);
+  EXPECT_EQ(fragment_count(kFragmentWords), 1);
+  EXPECT_EQ(fragment_count(kFragmentWords + 1), 2);
+}
+
+TEST(FragmentTests, SingleFragmentPayload) {
+  Reassembler reassembler{1000, 1s};
+  const auto payload = make_payload(17, 1);
+  auto fragments = split(3, payload);
+  ASSERT_EQ(fragments.size(), 1);
+
+  const auto result = read(reassembler, fragments[0], at(0ms));
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(*result, payload);
+  EXPECT_FALSE(reassembler.collecting());
+}
+
+TEST(FragmentTests, GivenShuffledDuplicatedFragments_PayloadReassembled) {
+  // about a full WorldFrame of poses
+  constexpr std::size_t kWords = 65536 * 3 + 5;
+  Reassembler reassembler{kWords, 1s};
+  const auto payload = make_payload(kWords, 2);
+  auto fragments = split(9, payload);
+  ASSERT_EQ(fragments.size(), fragment_count(kWords));
+
+  std::mt19937 rng{3};
+  std::vector<std::size_t> order(fragments.size());
+  std::iota(order.begin(), order.end(), 0);
+  order.insert(order.end(), order.begin(), order.begin() + 50);
+  std::shuffle(order.begin(), order.end(), rng);
+
+  std::optional<std::vector<u32>> result;
+  std::size_t reads = 0;
+  for (auto i : order) {
+    ++reads;
+    result = read(reassembler, fragments[i], at(0ms));
+    if (result) {
+      break;
+    }
+  }
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_TRUE(*result == payload);
+
+  // duplicates after completion don't restart the group
+  for (auto i : std::span{order}.subspan(reads)) {
+    EXPECT_FALSE(read(reassembler, fragments[i], at(0ms)));
+  }
+  EXPECT_FALSE(reassembler.collecting());
+}
+
+TEST(FragmentTests, MissingFragmentNeverCompletes) {
+  Reassembler reassembler{2000, 1s};
+  auto fragments = split(1, make_payload(1500, 4));
+  for (std::size_t i = 1; i < fragments.size(); ++i) {
+    EXPECT_FALSE(read(reassembler, fragments[i], at(0ms)));
+  }
+  EXPECT_TRUE(reassembler.collecting());
+  EXPECT_EQ(reassembler.received_count(), fragments.size() - 1);
+}
+
+TEST(FragmentTests, GroupTimesOutWithoutFragments) {
+  Reassembler reassembler{2000, 100ms};
+  const auto payload = make_payload(1500, 5);
+  auto fragments = split(1, payload);
+
+  EXPECT_FALSE(read(reassembler, fragments[0], at(0ms)));
+  EXPECT_FALSE(read(reassembler, fragments[1], at(90ms)));
+  reassembler.update(at(150ms));
+  EXPECT_TRUE(reassembler.collecting());
+  reassembler.update(at(250ms));
+  EXPECT_FALSE(reassembler.collecting());
+
+  // starting over needs every fragment again
+  std::optional<std::vector<u32>> result;
+  for (std::size_t i = 2; i < fragments.size(); ++i) {
+    result = read(reassembler, fragments[i], at(300ms));
+  }
+  EXPECT_FALSE(result);
+  EXPECT_FALSE(read(reassembler, fragments[0], at(300ms)));
+  result = read(reassembler, fragments[1], at(300ms));
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(*result, payload);
+}
+
+TEST(FragmentTests, NewerGroupReplacesOlderOneAndOldIsIgnored) {
+  Reassembler reassembler{2000, 1s};
+  auto old_fragments = split(0xfffe, make_payload(1000, 6));
+  const auto payload = make_payload(700, 7);
+  auto new_fragments = split(2, payload);  // newer, wrapped around
+
+  EXPECT_FALSE(read(reassembler, old_fragments[0], at(0ms)));
+  EXPECT_FALSE(read(reassembler, new_fragments[0], at(0ms)));
+  EXPECT_EQ(reassembler.group(), 2);
+  EXPECT_FALSE(read(reassembler, old_fragments[1], at(0ms)));
+  EXPECT_EQ(reassembler.group(), 2);
+
+  EXPECT_FALSE(read(reassembler, new_fragments[1], at(0ms)));
+  const auto result = read(reassembler, new_fragments[2], at(0ms));
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(*result, payload);
+}
+
+TEST(FragmentTests, PayloadsLargerThanBufferIgnored) {
+  Reassembler reassembler{500, 1s};
+  auto fragments = split(1, make_payload(1000, 8));
+  for (auto& fragment : fragments) {
+    EXPECT_FALSE(read(reassembler, fragment, at(0ms)));
+  }
+  EXPECT_EQ(reassembler.received_count(), 0);
+}
+
+TEST(FragmentTests, MalformedHeadersIgnored) {
+  Reassembler reassembler{2000, 1s};
+  const auto write_header = [](FragmentHeader header) {
+    Datagram datagram(kFragmentDataSizeBytes / 4);
+    bitpack::Packer packer{datagram};
+    pack(packer, header);
+    return datagram;
+  };
+
+  // index past count, short middle fragment, empty last fragment, oversized
+  for (auto header : {FragmentHeader{1, 3, 3, kFragmentWords},
+                      FragmentHeader{1, 0, 3, 10}, FragmentHeader{1, 2, 3, 0},
+                      FragmentHeader{1, 0, 1, kFragmentWords + 1}}) {
+    auto datagram = write_header(header);
+    bitpack::CheckedUnpacker unpacker{datagram};
+    EXPECT_FALSE(reassembler.read(unpacker, at(0ms)));
+  }
+  EXPECT_FALSE(reassembler.collecting());
+}
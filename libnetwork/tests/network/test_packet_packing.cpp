@@ -145,15 +145,10 @@ TEST(PacketPackingTests, PackMessageWithExtraValue) {
 
       // DATA
       // DATA | HEADER
-      // index
-      201,
-      0,
-      0,
-      0,
-      // receipt index
+      // index (high 16 bits) + receipt index (low 16 bits)
       195,
       0,
-      0,
+      201,
       0,
       // receipt flags
       0b10111111,
@@ -201,6 +196,11 @@ TEST(PacketPackingTests, PackMessageWithExtraValue) {
       0,
       0,
       0,
+
+      0,
+      0,
+      0,
+      0,
   }};
 
   EXPECT_THAT(packet_data, testing::ContainerEq(expected_data));
@@ -238,15 +238,10 @@ TEST(PacketPackingTests, UnpackMessageWithExtraValue) {
 
       // DATA
       // DATA | HEADER
-      // index
-      201,
-      0,
-      0,
-      0,
-      // receipt index
+      // index (high 16 bits) + receipt index (low 16 bits)
       195,
       0,
-      0,
+      201,
       0,
       // receipt flags
       0b10111111,
@@ -294,6 +289,11 @@ TEST(PacketPackingTests, UnpackMessageWithExtraValue) {
       0,
       0,
       0,
+
+      0,
+      0,
+      0,
+      0,
   }};
   Packet* packet = Packet::unsafe_init(packet_data.data(), kPacketSize, {});
 
@@ -365,15 +365,10 @@ TEST(PacketPackingTests, PackMessageWithoutExtraValue) {
 
       // DATA
       // DATA | HEADER
-      // index
-      201,
-      0,
-      0,
-      0,
-      // receipt index
+      // index (high 16 bits) + receipt index (low 16 bits)
       195,
       0,
-      0,
+      201,
       0,
       // receipt flags
       0b10111111,
@@ -420,6 +415,11 @@ TEST(PacketPackingTests, PackMessageWithoutExtraValue) {
       0,
       0,
       0,
+
+      0,
+      0,
+      0,
+      0,
   }};
 
   EXPECT_THAT(packet_data, testing::ContainerEq(expected_data));
@@ -457,15 +457,10 @@ TEST(PacketPackingTests, UnpackMessageWithoutExtraValue) {
 
       // DATA
       // DATA | HEADER
-      // index
-      201,
-      0,
-      0,
-      0,
-      // receipt index
+      // index (high 16 bits) + receipt index (low 16 bits)
       195,
       0,
-      0,
+      201,
       0,
       // receipt flags
       0b10111111,
@@ -513,6 +508,11 @@ TEST(PacketPackingTests, UnpackMessageWithoutExtraValue) {
       0,
       0,
       0,
+
+      0,
+      0,
+      0,
+      0,
   }};
   Packet* packet = Packet::unsafe_init(packet_data.data(), kPacketSize, {});
 
@@ -535,4 +535,129 @@ TEST(PacketPackingTests, UnpackMessageWithoutExtraValue) {
   EXPECT_EQ(message.pos_z, 6.125f);
   EXPECT_EQ(message.write_value, false);
   EXPECT_EQ(message.value, 0);
-}
\ No newline at end of file
+}
+
+TEST(PacketPackingTests, WorstCaseMessageSizeKnownAtCompileTime) {
+  constexpr auto kDataSize = Packet::data_size_bytes([](auto& packer) {
+    Message message{};
+    message.write_value = true;
+    pack(packer, message);
+  });
+  // header (2 * 16 + 32) + id, pos (4 * 32) + write_value (1) + value (64)
+  static_assert(kDataSize == 36);
+  constexpr auto kPacketAllocSize = Packet::alloc_size_bytes(kDataSize);
+
+  alignas(Packet::kAlignment) std::array<u8, kPacketAllocSize> packet_data{};
+  Packet* packet = Packet::unsafe_init(packet_data.data(), kDataSize,
+                                       {201, 195, 0b1011});
+
+  Message message1{12347, 2.0f, 4.5f, 6.125f, true, ~u64{0}};
+  packet->pack([&message1](auto& packer) { pack(packer, message1); });
+
+  Message message2{};
+  packet->unpack([&message2](auto& packer) { pack(packer, message2); });
+  EXPECT_EQ(message1, message2);
+}
+
+TEST(PacketPackingTests, UnpackCheckedRejectsTruncatedMessage) {
+  constexpr auto kDataSize = Packet::data_size_bytes([](auto& packer) {
+    Message message{};
+    message.write_value = true;
+    pack(packer, message);
+  });
+  constexpr auto kPacketAllocSize = Packet::alloc_size_bytes(kDataSize);
+
+  alignas(Packet::kAlignment) std::array<u8, kPacketAllocSize> packet_data{};
+  Packet* packet =
+      Packet::unsafe_init(packet_data.data(), kDataSize, {201, 195, 0});
+  Message message1{12347, 2.0f, 4.5f, 6.125f, true, 432};
+  packet->pack([&message1](auto& packer) { pack(packer, message1); });
+
+  Message message2{};
+  EXPECT_TRUE(packet->unpack_checked(
+      [&message2](auto& packer) { pack(packer, message2); }));
+  EXPECT_EQ(message1, message2);
+
+  // same bytes, but the datagram claimed to be one word short
+  Packet* truncated = Packet::unsafe_init(packet_data.data(),
+                                          kDataSize - sizeof(u32), {});
+  Message message3{};
+  EXPECT_FALSE(truncated->unpack_checked(
+      [&message3](auto& packer) { pack(packer, message3); }));
+  EXPECT_EQ(truncated->index(), 201);
+}
+
+TEST(PacketPackingTests, FinishReceiveUnpacksHeaderInPlace) {
+  constexpr u32 kCapacity = 64;
+  constexpr auto kPacketAllocSize = Packet::alloc_size_bytes(kCapacity);
+  constexpr auto kDataSize = Packet::data_size_bytes([](auto& packer) {
+    Message message{};
+    pack(packer, message);
+  });
+
+  // what the sender put on the wire
+  alignas(Packet::kAlignment) std::array<u8, kPacketAllocSize> sent_data{};
+  Packet* sent =
+      Packet::unsafe_init(sent_data.data(), kDataSize, {201, 195, 0b101});
+  Message message1{12347, 2.0f, 4.5f, 6.125f, false, 0};
+  sent->pack([&message1](auto& packer) { pack(packer, message1); });
+
+  // a receive buffer as big as the largest packet, filled like recvfrom would
+  alignas(Packet::kAlignment) std::array<u8, kPacketAllocSize> received_data{};
+  Packet* received = Packet::unsafe_init(received_data.data(), kCapacity, {});
+  std::copy(sent->begin(), sent->end(), received->begin());
+
+  ASSERT_TRUE(received->finish_receive(sent->size_bytes()));
+  EXPECT_EQ(received->size_bytes(), kDataSize);
+  EXPECT_EQ(received->index(), 201);
+  EXPECT_EQ(received->receipt_index(), 195);
+  EXPECT_EQ(received->receipt_flags(), 0b101);
+
+  Message message2{};
+  EXPECT_TRUE(received->unpack_checked(
+      [&message2](auto& packer) { pack(packer, message2); }));
+  EXPECT_EQ(message1, message2);
+}
+
+TEST(PacketPackingTests, FinishReceiveRejectsDatagramsThatArentPackets) {
+  constexpr u32 kCapacity = 64;
+  alignas(Packet::kAlignment)
+      std::array<u8, Packet::alloc_size_bytes(kCapacity)> packet_data{};
+
+  constexpr u32 kHeaderBytes = Packet::data_size_bytes([](auto&) {});
+
+  // shorter than the header
+  Packet* packet = Packet::unsafe_init(packet_data.data(), kCapacity, {});
+  EXPECT_FALSE(packet->finish_receive(kHeaderBytes - sizeof(u32)));
+
+  // not whole words
+  packet = Packet::unsafe_init(packet_data.data(), kCapacity, {});
+  EXPECT_FALSE(packet->finish_receive(kHeaderBytes + 1));
+
+  packet = Packet::unsafe_init(packet_data.data(), kCapacity, {});
+  EXPECT_FALSE(packet->finish_receive(0));
+}
+
+TEST(PacketPackingTests, HeaderSendsSixteenBitIndices) {
+  EXPECT_EQ(Packet::data_size_bytes([](auto&) {}), 2 * sizeof(u32));
+
+  constexpr u32 kCapacity = 16;
+  alignas(Packet::kAlignment)
+      std::array<u8, Packet::alloc_size_bytes(kCapacity)> sent_data{};
+  Packet* sent = Packet::unsafe_init(sent_data.data(), kCapacity,
+                                     {0x12345678, 0x0001ffff, 0xdeadbeef});
+  sent->pack([](auto&) {});
+
+  alignas(Packet::kAlignment)
+      std::array<u8, Packet::alloc_size_bytes(kCapacity)> received_data{};
+  Packet* received = Packet::unsafe_init(received_data.data(), kCapacity, {});
+  std::copy(sent->begin(), sent->end(), received->begin());
+
+  ASSERT_TRUE(received->finish_receive(2 * sizeof(u32)));
+  EXPECT_EQ(received->index(), 0x5678);
+  EXPECT_EQ(received->receipt_index(), 0xffff);
+  EXPECT_EQ(received->receipt_flags(), 0xdeadbeef);
+
+  // packing doesn't touch the sender's full indices
+  EXPECT_EQ(sent->index(), 0x12345678);
+}
@@ -0,0 +1,123 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <glue/network/packet_pool.hpp>
+#include <glue/pointers.hpp>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace glue;
+using namespace glue::network;
+
+TEST(PacketPoolTests, AcquiredPacketsAreInitializedAndAligned) {
+  PacketPool pool{100, 4};
+  Packet* packet = pool.acquire({7, 3, 0b101});
+  ASSERT_NE(packet, nullptr);
+
+  EXPECT_TRUE(ptr_is_aligned(packet, Packet::kAlignment));
+  EXPECT_EQ(packet->size_bytes(), 100);
+  EXPECT_EQ(packet->index(), 7);
+  EXPECT_EQ(packet->receipt_index(), 3);
+  EXPECT_EQ(packet->receipt_flags(), 0b101);
+  EXPECT_TRUE(pool.owns(packet));
+}
+
+TEST(PacketPoolTests, SlotsDoNotOverlap) {
+  PacketPool pool{13, 8};
+  EXPECT_EQ(pool.slot_size_bytes(), Packet::alloc_size_bytes(13));
+
+  std::vector<Packet*> packets;
+  for (u32 i = 0; i < pool.capacity(); ++i) {
+    packets.push_back(pool.acquire({i, 0, 0}));
+    std::fill(packets.back()->begin(), packets.back()->end(),
+              static_cast<u8>(i));
+  }
+
+  for (u32 i = 0; i < pool.capacity(); ++i) {
+    EXPECT_EQ(packets[i]->index(), i);
+    EXPECT_EQ(packets[i]->size_bytes(), 13);
+    EXPECT_TRUE(std::all_of(packets[i]->begin(), packets[i]->end(),
+                            [&](u8 value) { return value == i; }));
+  }
+}
+
+TEST(PacketPoolTests, WhenExhausted_AcquireReturnsNull) {
+  PacketPool pool{16, 3};
+  std::set<Packet*> packets;
+  for (int i = 0; i < 3; ++i) {
+    packets.insert(pool.acquire());
+  }
+  EXPECT_EQ(packets.size(), 3);
+  EXPECT_FALSE(packets.contains(nullptr));
+  EXPECT_EQ(pool.acquire(), nullptr);
+
+  pool.release(*packets.begin());
+  EXPECT_EQ(pool.acquire(), *packets.begin());
+  EXPECT_EQ(pool.acquire(), nullptr);
+}
+
+TEST(PacketPoolTests, EmptyPoolAcquireReturnsNull) {
+  PacketPool pool{16, 0};
+  EXPECT_EQ(pool.acquire(), nullptr);
+}
+
+TEST(PacketPoolTests, OwnsOnlyItsOwnSlots) {
+  PacketPool pool{16, 2};
+  PacketPool other{16, 2};
+  Packet* packet = pool.acquire();
+  Packet local{};
+
+  EXPECT_TRUE(pool.owns(packet));
+  EXPECT_FALSE(other.owns(packet));
+  EXPECT_FALSE(pool.owns(&local));
+  EXPECT_FALSE(pool.owns(reinterpret_cast<Packet*>(
+      reinterpret_cast<u8*>(packet) + sizeof(u32))));
+}
+
+TEST(PacketPoolDeathTests, ReleasingForeignPacketAsserts) {
+  PacketPool pool{16, 2};
+  Packet local{};
+  EXPECT_DEATH(pool.release(&local), "Assertion.*");
+}
+
+TEST(PacketPoolTests, GivenManyThreads_PacketsNeverHandedOutTwice) {
+  constexpr u32 kThreads = 4;
+  constexpr u32 kIterations = 20000;
+  PacketPool pool{sizeof(u32), 8};
+
+  std::atomic<bool> failed{false};
+  std::vector<std::thread> threads;
+  for (u32 t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (u32 i = 0; i < kIterations; ++i) {
+        Packet* packet = pool.acquire();
+        if (packet == nullptr) {
+          continue;
+        }
+
+        // another owner would overwrite the tag before we check it
+        auto& owner = *reinterpret_cast<u32*>(packet->data());
+        owner = t;
+        std::this_thread::yield();
+        if (owner != t) {
+          failed = true;
+        }
+        pool.release(packet);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_FALSE(failed);
+
+  // every slot made it back to the free list
+  std::set<Packet*> packets;
+  while (Packet* packet = pool.acquire()) {
+    packets.insert(packet);
+  }
+  EXPECT_EQ(packets.size(), pool.capacity());
+}
@@ -0,0 +1,280 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <glue/network/reliable_channel.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace glue;
+using namespace glue::network;
+using namespace std::chrono_literals;
+
+namespace {
+using Datagram = std::vector<u32>;
+
+constexpr std::size_t kDatagramWords = 128;
+
+/*
+ * One side of a connection: a Connection, its ReliableChannel and what the
+ * channel delivered.
+ */
+struct Endpoint {
+  Connection connection;
+  ReliableChannel channel;
+  std::vector<std::string> delivered;
+  std::vector<u32> unreliable;
+
+  Endpoint() { connection.set_listener(&channel); }
+
+  Endpoint(const Endpoint&) = delete;
+  Endpoint& operator=(const Endpoint&) = delete;
+
+  bool send(const std::string& message) {
+    return channel.send({reinterpret_cast<const u8*>(message.data()),
+                         message.size()});
+  }
+
+  Datagram write(Connection::Clock::time_point now, u32 tick) {
+    Datagram datagram(kDatagramWords);
+    bitpack::Packer packer{datagram};
+    auto header = connection.next_header(now);
+    pack(packer, header);
+
+    // leave room for the unreliable data
+    const std::size_t budget = packer.capacity_bits() - packer.current_bit();
+    channel.write(packer, header.index, budget - 32);
+    bitpack::pack(packer, tick);
+    return datagram;
+  }
+
+  void read(Datagram& datagram, Connection::Clock::time_point now) {
+    bitpack::CheckedUnpacker unpacker{datagram};
+    PacketHeader header{};
+    pack(unpacker, header);
+    ASSERT_TRUE(channel.read(unpacker, [&](std::span<const u8> message) {
+      delivered.emplace_back(message.begin(), message.end());
+    }));
+    u32 tick = 0;
+    bitpack::pack(unpacker, tick);
+    ASSERT_FALSE(unpacker.overflowed());
+
+    unreliable.push_back(tick);
+    connection.on_receive(header, now);
+  }
+};
+
+u32 written_message_count(Datagram datagram) {
+  bitpack::Unpacker unpacker{datagram};
+  PacketHeader header{};
+  pack(unpacker, header);
+  return unpacker.read_bits(ReliableChannel::kCountBits);
+}
+
+Connection::Clock::time_point at(u32 tick) {
+  return Connection::Clock::time_point{} + tick * 16ms;
+}
+}  // namespace
+
+TEST(ReliableChannelTests, MessagesDeliveredInOrder) {
+  Endpoint a;
+  Endpoint b;
+  ASSERT_TRUE(a.send("join"));
+  ASSERT_TRUE(a.send("score 10"));
+  ASSERT_TRUE(a.send(""));
+
+  auto datagram = a.write(at(0), 0);
+  b.read(datagram, at(1));
+
+  EXPECT_THAT(b.delivered, ::testing::ElementsAre("join", "score 10", ""));
+  EXPECT_THAT(b.unreliable, ::testing::ElementsAre(0));
+}
+
+TEST(ReliableChannelTests, InFlightMessagesAreNotResent) {
+  Endpoint a;
+  Endpoint b;
+  ASSERT_TRUE(a.send("chat"));
+
+  auto first = a.write(at(0), 0);
+  auto second = a.write(at(1), 1);
+  EXPECT_EQ(written_message_count(first), 1);
+  EXPECT_EQ(written_message_count(second), 0);
+
+  // acked through b's next packet
+  b.read(first, at(2));
+  auto reply = b.write(at(2), 2);
+  a.read(reply, at(3));
+  EXPECT_EQ(a.channel.unacked_count(), 0);
+  EXPECT_EQ(written_message_count(a.write(at(4), 4)), 0);
+}
+
+TEST(ReliableChannelTests, LostMessagesResentOnceLossIsKnown) {
+  Endpoint a;
+  Endpoint b;
+  ASSERT_TRUE(a.send("lost"));
+  a.write(at(0), 0);  // dropped
+
+  // b keeps hearing from a, so packet 1 falls out of the ack window
+  for (u32 tick = 1; tick < 40; ++tick) {
+    auto datagram = a.write(at(tick), tick);
+    EXPECT_EQ(written_message_count(datagram), 0);
+    b.read(datagram, at(tick));
+  }
+  EXPECT_TRUE(b.delivered.empty());
+
+  auto reply = b.write(at(40), 40);
+  a.read(reply, at(40));
+  // b never acked 1..7, only packet 1 carried a message
+  EXPECT_EQ(a.connection.lost_count(), 7);
+
+  auto resend = a.write(at(41), 41);
+  EXPECT_EQ(written_message_count(resend), 1);
+  b.read(resend, at(41));
+  EXPECT_THAT(b.delivered, ::testing::ElementsAre("lost"));
+}
+
+TEST(ReliableChannelTests, MessagesHeldBackUntilGapFilled) {
+  Endpoint a;
+  Endpoint b;
+  ASSERT_TRUE(a.send("first"));
+  auto first = a.write(at(0), 0);
+  ASSERT_TRUE(a.send("second"));
+  auto second = a.write(at(1), 1);
+
+  b.read(second, at(2));
+  EXPECT_TRUE(b.delivered.empty());
+  EXPECT_THAT(b.unreliable, ::testing::ElementsAre(1));
+
+  b.read(first, at(3));
+  EXPECT_THAT(b.delivered, ::testing::ElementsAre("first", "second"));
+}
+
+TEST(ReliableChannelTests, WindowLimitsUnackedMessages) {
+  ReliableChannel channel;
+  const u8 byte = 1;
+  for (u32 i = 0; i < ReliableChannel::kMessageWindow; ++i) {
+    ASSERT_TRUE(channel.send({&byte, 1}));
+  }
+  EXPECT_FALSE(channel.send({&byte, 1}));
+  EXPECT_EQ(channel.unacked_count(), ReliableChannel::kMessageWindow);
+}
+
+TEST(ReliableChannelTests, WriteRespectsBitBudget) {
+  ReliableChannel channel;
+  std::array<u8, 100> message{};
+  ASSERT_TRUE(channel.send(message));
+  ASSERT_TRUE(channel.send(message));
+
+  Datagram datagram(kDatagramWords);
+  bitpack::Packer packer{datagram};
+  const std::size_t one_message =
+      ReliableChannel::kCountBits + ReliableChannel::kIdBits +
+      MessageFraming::body_bits(static_cast<u32>(message.size()));
+  channel.write(packer, 1, one_message + 10);
+  EXPECT_EQ(packer.current_bit(), one_message);
+}
+
+TEST(ReliableChannelTests, MalformedCountRejected) {
+  Datagram datagram(4);
+  bitpack::Packer packer{datagram};
+  packer.write_bits(ReliableChannel::kMaxMessagesPerPacket + 1,
+                    ReliableChannel::kCountBits);
+
+  ReliableChannel channel;
+  bitpack::Unpacker unpacker{datagram};
+  EXPECT_FALSE(channel.read(unpacker, [](std::span<const u8>) {}));
+}
+
+TEST(ReliableChannelTests, MalformedLaterMessageDropsWholePacket) {
+  Datagram datagram(4);
+  bitpack::Packer packer{datagram};
+  packer.write_bits(2, ReliableChannel::kCountBits);
+  packer.write_bits(0, ReliableChannel::kIdBits);
+  packer.write_bits(1, MessageFraming::kSizeBits);
+  packer.write_bits('x', 8);
+  packer.write_bits(1, ReliableChannel::kIdBits);
+  packer.write_bits(ReliableChannel::kMaxMessageBytes + 1,
+                    MessageFraming::kSizeBits);
+
+  ReliableChannel channel;
+  u32 delivered = 0;
+  bitpack::Unpacker unpacker{datagram};
+  EXPECT_FALSE(
+      channel.read(unpacker, [&](std::span<const u8>) { ++delivered; }));
+  EXPECT_EQ(delivered, 0);
+}
+
+TEST(ReliableChannelTests, TruncatedPacketDropsWholePacket) {
+  Endpoint a;
+  ASSERT_TRUE(a.send("first"));
+  ASSERT_TRUE(a.send(std::string(200, 'x')));
+  auto datagram = a.write(at(0), 0);
+
+  // cut off in the middle of the second message
+  Datagram truncated(datagram.begin(), datagram.begin() + 10);
+  ReliableChannel channel;
+  u32 delivered = 0;
+  bitpack::CheckedUnpacker unpacker{truncated};
+  PacketHeader header{};
+  pack(unpacker, header);
+  EXPECT_FALSE(
+      channel.read(unpacker, [&](std::span<const u8>) { ++delivered; }));
+  EXPECT_EQ(delivered, 0);
+}
+
+TEST(ReliableChannelTests, GivenHeavyLoss_AllMessagesArriveInOrderOnce) {
+  constexpr u32 kMessages = 500;
+  constexpr u32 kTicks = 20000;
+
+  Endpoint a;
+  Endpoint b;
+  std::mt19937 rng{1234};
+  std::bernoulli_distribution lose{0.3};
+  std::bernoulli_distribution duplicate{0.05};
+  std::uniform_int_distribution<u32> burst{0, 4};
+
+  // one packet each way per tick, delayed by a tick, some lost, some
+  // delivered twice
+  u32 next_message = 0;
+  std::vector<Datagram> a_to_b;
+  std::vector<Datagram> b_to_a;
+  for (u32 tick = 0; tick < kTicks; ++tick) {
+    for (u32 i = burst(rng); i > 0 && next_message < kMessages; --i) {
+      if (!a.send("message " + std::to_string(next_message))) {
+        break;
+      }
+      ++next_message;
+    }
+
+    for (auto& datagram : a_to_b) {
+      b.read(datagram, at(tick));
+    }
+    for (auto& datagram : b_to_a) {
+      a.read(datagram, at(tick));
+    }
+    a_to_b.clear();
+    b_to_a.clear();
+
+    auto from_a = a.write(at(tick), tick);
+    auto from_b = b.write(at(tick), tick);
+    if (!lose(rng)) {
+      a_to_b.push_back(from_a);
+      if (duplicate(rng)) {
+        a_to_b.push_back(from_a);
+      }
+    }
+    if (!lose(rng)) {
+      b_to_a.push_back(from_b);
+    }
+
+    if (b.delivered.size() == kMessages) {
+      break;
+    }
+  }
+
+  ASSERT_EQ(b.delivered.size(), kMessages);
+  for (u32 i = 0; i < kMessages; ++i) {
+    EXPECT_EQ(b.delivered[i], "message " + std::to_string(i));
+  }
+  EXPECT_GT(a.connection.lost_count(), 0);
+}
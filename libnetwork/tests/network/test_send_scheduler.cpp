@@ -0,0 +1,200 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <glue/network/send_scheduler.hpp>
+#include <string>
+#include <vector>
+
+using namespace glue;
+using namespace glue::network;
+using namespace std::chrono_literals;
+
+namespace {
+constexpr std::size_t kDatagramWords = 300;
+
+SendScheduler::Clock::time_point at(std::chrono::milliseconds ms) {
+  return SendScheduler::Clock::time_point{} + ms;
+}
+
+bool queue(SendScheduler& scheduler, const std::string& message, u8 priority,
+           SendScheduler::Clock::time_point deadline = at(1h)) {
+  return scheduler.queue({reinterpret_cast<const u8*>(message.data()),
+                          message.size()},
+                         priority, deadline);
+}
+
+/*
+ * Writes a packet's worth of messages and reads them back.
+ */
+std::vector<std::string> write_tick(
+    SendScheduler& scheduler, SendScheduler::Clock::time_point now,
+    std::size_t max_bits = kDatagramWords * 32) {
+  std::vector<u32> datagram(kDatagramWords);
+  bitpack::Packer packer{datagram};
+  scheduler.write(packer, now, max_bits);
+
+  std::vector<std::string> out;
+  bitpack::CheckedUnpacker unpacker{datagram};
+  EXPECT_TRUE(
+      SendScheduler::read(unpacker, [&](std::span<const u8> message) {
+        out.emplace_back(message.begin(), message.end());
+      }));
+  EXPECT_FALSE(unpacker.overflowed());
+  return out;
+}
+
+SendScheduler::Config fixed_rate(f64 rate, f64 burst) {
+  return {.initial_rate = rate,
+          .min_rate = rate,
+          .max_rate = rate,
+          .burst_bytes = burst};
+}
+}  // namespace
+
+TEST(SendSchedulerTests, GivenNothingQueued_WritesEmptyCount) {
+  SendScheduler scheduler;
+  EXPECT_TRUE(write_tick(scheduler, at(0ms)).empty());
+  EXPECT_EQ(scheduler.sent_bytes(), 0);
+}
+
+TEST(SendSchedulerTests, HigherPriorityFirstThenOldest) {
+  SendScheduler scheduler;
+  ASSERT_TRUE(queue(scheduler, "low", 0));
+  ASSERT_TRUE(queue(scheduler, "high 1", 5));
+  ASSERT_TRUE(queue(scheduler, "mid", 2));
+  ASSERT_TRUE(queue(scheduler, "high 2", 5));
+
+  EXPECT_THAT(write_tick(scheduler, at(0ms)),
+              testing::ElementsAre("high 1", "high 2", "mid", "low"));
+  EXPECT_EQ(scheduler.queued_count(), 0);
+  EXPECT_EQ(scheduler.sent_bytes(), 18);
+}
+
+TEST(SendSchedulerTests, MessagesThatDontFitWaitForNextPacket) {
+  SendScheduler scheduler;
+  const std::string big(200, 'x');
+  ASSERT_TRUE(queue(scheduler, big, 2));
+  ASSERT_TRUE(queue(scheduler, big, 1));
+  ASSERT_TRUE(queue(scheduler, "small", 0));
+
+  // room for one big message and the small one behind the other
+  const std::size_t max_bits = SendScheduler::kCountBits + 2 * 9 + 205 * 8;
+  EXPECT_THAT(write_tick(scheduler, at(0ms), max_bits),
+              testing::ElementsAre(big, "small"));
+  EXPECT_EQ(scheduler.deferred_bytes(), 200);
+
+  EXPECT_THAT(write_tick(scheduler, at(10ms), max_bits),
+              testing::ElementsAre(big));
+  EXPECT_EQ(scheduler.deferred_bytes(), 200);
+}
+
+TEST(SendSchedulerTests, BudgetLimitsBytesPerTick) {
+  // 2000 bytes/s is 100 bytes per 50ms tick
+  SendScheduler scheduler{fixed_rate(2000.0, 100.0)};
+  const std::string message(48, 'x');
+
+  std::size_t sent = 0;
+  for (u32 tick = 0; tick < 100; ++tick) {
+    const auto now = at(std::chrono::milliseconds{tick * 50});
+    queue(scheduler, message, 0, now + 1s);
+    queue(scheduler, message, 0, now + 1s);
+    queue(scheduler, message, 0, now + 1s);
+    sent += write_tick(scheduler, now).size();
+  }
+
+  // 5s at 2000 bytes/s, about 50 bytes per message on the wire
+  EXPECT_NEAR(sent * 50.0, 10000.0, 500.0);
+  EXPECT_GT(scheduler.deferred_bytes(), 0);
+}
+
+TEST(SendSchedulerTests, ExpiredMessagesDropped) {
+  SendScheduler scheduler{fixed_rate(1000.0, 60.0)};
+  const std::string message(50, 'x');
+  ASSERT_TRUE(queue(scheduler, message, 0, at(100ms)));
+  ASSERT_TRUE(queue(scheduler, message, 0, at(100ms)));
+
+  EXPECT_EQ(write_tick(scheduler, at(0ms)).size(), 1);
+  EXPECT_EQ(scheduler.deferred_bytes(), 50);
+
+  // the budget refills by 50 bytes, but too late
+  EXPECT_TRUE(write_tick(scheduler, at(101ms)).empty());
+  EXPECT_EQ(scheduler.dropped_bytes(), 50);
+  EXPECT_EQ(scheduler.queued_count(), 0);
+}
+
+TEST(SendSchedulerTests, FullQueueDropsNewMessages) {
+  SendScheduler scheduler;
+  for (u32 i = 0; i < SendScheduler::kMaxQueued; ++i) {
+    ASSERT_TRUE(queue(scheduler, "abc", 0));
+  }
+  EXPECT_FALSE(queue(scheduler, "abcd", 0));
+  EXPECT_EQ(scheduler.dropped_bytes(), 4);
+}
+
+TEST(SendSchedulerTests, AdaptCutsRateOnLossAndGrowsOtherwise) {
+  SendScheduler::Config config{.initial_rate = 10000.0,
+                               .min_rate = 1000.0,
+                               .max_rate = 20000.0,
+                               .rate_decrease = 0.5,
+                               .rate_increase = 1000.0};
+  SendScheduler scheduler{config};
+
+  scheduler.adapt(0.0, 0.05);
+  EXPECT_DOUBLE_EQ(scheduler.rate(), 11000.0);
+
+  scheduler.adapt(0.1, 0.05);
+  EXPECT_DOUBLE_EQ(scheduler.rate(), 5500.0);
+
+  for (int i = 0; i < 10; ++i) {
+    scheduler.adapt(0.1, 0.05);
+  }
+  EXPECT_DOUBLE_EQ(scheduler.rate(), 1000.0);
+
+  for (int i = 0; i < 100; ++i) {
+    scheduler.adapt(0.0, 0.05);
+  }
+  EXPECT_DOUBLE_EQ(scheduler.rate(), 20000.0);
+}
+
+TEST(SendSchedulerTests, AdaptCutsRateWhenRttInflates) {
+  SendScheduler::Config config{.initial_rate = 10000.0,
+                               .min_rate = 1000.0,
+                               .rate_decrease = 0.5,
+                               .rate_increase = 1000.0};
+  SendScheduler scheduler{config};
+
+  scheduler.adapt(0.0, 0.05);
+  scheduler.adapt(0.0, 0.07);
+  EXPECT_DOUBLE_EQ(scheduler.rate(), 12000.0);
+
+  // queueing in the network, no loss yet
+  scheduler.adapt(0.0, 0.1);
+  EXPECT_DOUBLE_EQ(scheduler.rate(), 6000.0);
+}
+
+TEST(SendSchedulerTests, AdaptForgetsMinRttAfterRouteChange) {
+  SendScheduler::Config config{.initial_rate = 10000.0,
+                               .min_rate = 1000.0,
+                               .rate_decrease = 0.5,
+                               .rate_increase = 1000.0,
+                               .min_rtt_window = 8};
+  SendScheduler scheduler{config};
+
+  scheduler.adapt(0.0, 0.05);
+  scheduler.adapt(0.0, 0.1);
+  EXPECT_DOUBLE_EQ(scheduler.rate(), 5500.0);
+
+  // two windows later 0.1 is the baseline, not inflation
+  for (int i = 0; i < 16; ++i) {
+    scheduler.adapt(0.0, 0.1);
+  }
+  const f64 rate = scheduler.rate();
+  scheduler.adapt(0.0, 0.1);
+  EXPECT_DOUBLE_EQ(scheduler.rate(), rate + 1000.0);
+}
+
+TEST(SendSchedulerTests, EmptyWriteLeavesBudgetAlone) {
+  SendScheduler scheduler{fixed_rate(1000.0, 100.0)};
+  EXPECT_TRUE(write_tick(scheduler, at(0ms)).empty());
+  EXPECT_DOUBLE_EQ(scheduler.budget().available(), 100.0);
+}
@@ -0,0 +1,99 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <glue/debug/timer.hpp>
+#include <glue/network/sharded_server.hpp>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace glue;
+using namespace glue::network;
+using namespace std::chrono_literals;
+
+TEST(ShardedServerTests, GivenManyClients_EachClientStaysOnOneShard) {
+  constexpr std::size_t kShards = 4;
+  constexpr std::size_t kClients = 32;
+  constexpr u32 kPacketsPerClient = 20;
+
+  std::mutex mutex;
+  std::unordered_map<IPv4Address, std::set<std::size_t>> shards_by_client;
+  std::atomic<u32> total{0};
+  std::atomic<bool> wrong_thread{false};
+  std::array<std::thread::id, kShards> shard_threads{};
+
+  auto server = ShardedServer::start(
+      0, kShards,
+      [&](std::size_t shard, Socket& socket, Connection& connection,
+          std::span<u8> data) {
+        // every shard's callbacks come from one thread, its own
+        {
+          std::lock_guard lock{mutex};
+          if (shard_threads[shard] == std::thread::id{}) {
+            shard_threads[shard] = std::this_thread::get_id();
+          } else if (shard_threads[shard] != std::this_thread::get_id()) {
+            wrong_thread = true;
+          }
+          shards_by_client[connection.address()].insert(shard);
+        }
+        EXPECT_NE(socket.port(), 0);
+        EXPECT_EQ(data.size(), sizeof(u32));
+        ++total;
+      });
+  ASSERT_NE(server, nullptr);
+  EXPECT_EQ(server->shard_count(), kShards);
+  const auto address = IPv4Address::loopback(server->port());
+
+  std::vector<Socket> clients;
+  for (std::size_t i = 0; i < kClients; ++i) {
+    auto client = Socket::open_any_port();
+    ASSERT_TRUE(client.has_value());
+    clients.push_back(std::move(*client));
+  }
+
+  // a round at a time, so the shards can keep up, but loopback may still
+  // drop some under load
+  for (u32 sequence = 0; sequence < kPacketsPerClient; ++sequence) {
+    for (auto& client : clients) {
+      u32 payload = sequence;
+      client.send(address, {reinterpret_cast<u8*>(&payload), sizeof(payload)});
+    }
+
+    debug::Timer timer;
+    while (total < (sequence + 1) * kClients &&
+           timer.elapsed_sec<f64>() < 0.1) {
+      std::this_thread::sleep_for(1ms);
+    }
+  }
+
+  // the socket counts a datagram before its callback runs
+  const u32 arrived = total;
+  u64 received = 0;
+  for (std::size_t shard = 0; shard < kShards; ++shard) {
+    received += server->socket_stats(shard).packets_received;
+  }
+  server.reset();
+
+  EXPECT_GT(arrived, 0);
+  EXPECT_GE(received, arrived);
+  EXPECT_LE(received, kClients * kPacketsPerClient);
+  EXPECT_FALSE(wrong_thread);
+  EXPECT_LE(shards_by_client.size(), kClients);
+  for (const auto& [client, shards] : shards_by_client) {
+    EXPECT_EQ(shards.size(), 1);
+  }
+}
+
+TEST(ShardedServerTests, DestructorStopsIdleShards) {
+  auto server = ShardedServer::start(
+      0, 3, [](std::size_t, Socket&, Connection&, std::span<u8>) {});
+  ASSERT_NE(server, nullptr);
+
+  debug::Timer timer;
+  server.reset();
+  EXPECT_LT(timer.elapsed_sec<f64>(), 1.0);
+}
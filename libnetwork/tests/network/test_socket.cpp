@@ -2,7 +2,10 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
 #include <glue/debug/timer.hpp>
+#include <glue/network/packet_pool.hpp>
 #include <glue/network/socket.hpp>
 #include <glue/types.hpp>
 #include <thread>
@@ -97,4 +100,322 @@ TEST_F(SocketTests, GivenSocketWithAnyPort_PortIsNonZero) {
   auto maybe_socket = Socket::open_any_port();
   ASSERT_TRUE(maybe_socket.has_value());
   EXPECT_NE(maybe_socket->port(), 0);
-}
\ No newline at end of file
+}
+TEST_F(SocketTests, GivenNothingSent_ReceiveBatchReturnsZero) {
+  auto [ip, socket] = open_test_socket();
+  std::array<u8, 16> buffer{};
+  std::vector<Datagram> datagrams(4, Datagram{buffer});
+  EXPECT_EQ(socket.receive_batch(datagrams), 0);
+}
+
+TEST_F(SocketTests, GivenBatchSent_BatchReceivedWithSizesAndSender) {
+  auto a = open_test_socket();
+  auto b = open_test_socket();
+  auto& [ip_a, socket_a] = a;
+  auto& [ip_b, socket_b] = b;
+
+  // more than one syscall's worth, each datagram a different size
+  constexpr std::size_t kCount = Socket::kMaxBatchSize + 36;
+  std::vector<std::vector<u8>> sent_data(kCount);
+  std::vector<Datagram> sent(kCount);
+  for (std::size_t i = 0; i < kCount; ++i) {
+    sent_data[i].resize(i % 32 + 1, static_cast<u8>(i));
+    sent[i] = {sent_data[i], 0, ip_b};
+  }
+  EXPECT_EQ(socket_a.send_batch(sent), kCount);
+
+  std::vector<std::array<u8, 64>> buffers(kCount);
+  std::vector<Datagram> received(kCount);
+  for (std::size_t i = 0; i < kCount; ++i) {
+    received[i].data = buffers[i];
+  }
+
+  std::size_t count = 0;
+  debug::Timer timer;
+  while (count < kCount && timer.elapsed_sec<f64>() < 0.250) {
+    count += socket_b.receive_batch(std::span{received}.subspan(count));
+  }
+
+  ASSERT_EQ(count, kCount);
+  for (std::size_t i = 0; i < kCount; ++i) {
+    EXPECT_EQ(received[i].address, ip_a);
+    ASSERT_EQ(received[i].size, sent_data[i].size());
+    EXPECT_TRUE(std::equal(sent_data[i].begin(), sent_data[i].end(),
+                           buffers[i].begin()));
+  }
+}
+
+TEST_F(SocketTests, GivenSmallBuffer_ReceiveBatchDropsOversizedDatagrams) {
+  auto a = open_test_socket();
+  auto b = open_test_socket();
+  auto& [ip_a, socket_a] = a;
+  auto& [ip_b, socket_b] = b;
+
+  std::vector<u8> oversized{1, 2, 3, 4, 5, 6, 7, 8};
+  std::vector<u8> fitting{9, 10};
+  socket_a.send(ip_b, oversized);
+  socket_a.send(ip_b, fitting);
+
+  std::array<std::array<u8, 4>, 2> buffers{};
+  std::array<Datagram, 2> received{Datagram{buffers[0]},
+                                   Datagram{buffers[1]}};
+  std::size_t count = 0;
+  debug::Timer timer;
+  while (count == 0 && timer.elapsed_sec<f64>() < 0.250) {
+    count = socket_b.receive_batch(received);
+  }
+
+  ASSERT_EQ(count, 1);
+  EXPECT_EQ(received[0].size, fitting.size());
+  EXPECT_THAT(received[0].data.first(2), ::testing::ElementsAre(9, 10));
+}
+
+TEST_F(SocketTests, OversizedDatagramNeverReceivedAsPacket) {
+  auto a = open_test_socket();
+  auto b = open_test_socket();
+  auto& [ip_a, socket_a] = a;
+  auto& [ip_b, socket_b] = b;
+
+  // a valid header with garbage after it, 200 bytes
+  PacketPool pool{200, 2};
+  Packet* sent = pool.acquire({7, 0, 0});
+  ASSERT_NE(sent, nullptr);
+  sent->pack([](auto&) {});
+  socket_a.send(ip_b, sent->as_span());
+
+  // would read the first 16 bytes as a packet if it were truncated
+  PacketPool small_pool{16, 1};
+  Packet* received = small_pool.acquire();
+  ASSERT_NE(received, nullptr);
+  IPv4Address sender;
+  bool got_packet = false;
+  debug::Timer timer;
+  while (!got_packet && timer.elapsed_sec<f64>() < 0.100) {
+    got_packet = socket_b.receive(*received, sender);
+  }
+  EXPECT_FALSE(got_packet);
+}
+
+TEST_F(SocketTests, OversizedDatagramSkippedForTheNextOne) {
+  auto a = open_test_socket();
+  auto b = open_test_socket();
+  auto& [ip_a, socket_a] = a;
+  auto& [ip_b, socket_b] = b;
+
+  std::vector<u8> oversized(200, 1);
+  std::vector<u8> fitting(8, 2);
+  socket_a.send(ip_b, oversized);
+  socket_a.send(ip_b, fitting);
+
+  std::array<u8, 16> buffer{};
+  IPv4Address sender;
+  std::optional<u32> size;
+  debug::Timer timer;
+  while (!size && timer.elapsed_sec<f64>() < 0.250) {
+    size = socket_b.receive(buffer, sender);
+  }
+  ASSERT_TRUE(size.has_value());
+  EXPECT_EQ(*size, fitting.size());
+  EXPECT_EQ(buffer[0], 2);
+}
+
+TEST_F(SocketTests, ReceiveReturnsDatagramSize) {
+  auto a = open_test_socket();
+  auto b = open_test_socket();
+  auto& [ip_a, socket_a] = a;
+  auto& [ip_b, socket_b] = b;
+
+  std::vector<u8> sent_data{1, 2, 3, 4, 5};
+  socket_a.send(ip_b, sent_data);
+
+  std::array<u8, 32> buffer{};
+  IPv4Address sender;
+  std::optional<u32> size;
+  debug::Timer timer;
+  while (!size && timer.elapsed_sec<f64>() < 0.250) {
+    size = socket_b.receive(buffer, sender);
+  }
+
+  ASSERT_TRUE(size.has_value());
+  EXPECT_EQ(*size, sent_data.size());
+  EXPECT_EQ(sender, ip_a);
+}
+
+TEST_F(SocketTests, GivenPooledPacket_ReceiveLandsInPacketWithRealSize) {
+  auto a = open_test_socket();
+  auto b = open_test_socket();
+  auto& [ip_a, socket_a] = a;
+  auto& [ip_b, socket_b] = b;
+
+  PacketPool pool{1200, 2};
+  Packet* sent = pool.acquire({17, 4, 0b11});
+  ASSERT_NE(sent, nullptr);
+  sent->pack([](auto& packer) {
+    u32 value = 0xdeadbeef;
+    pack(packer, value);
+  });
+  socket_a.send(ip_b, sent->as_span().first(Packet::data_size_bytes(
+                          [](auto& packer) { packer.write_bits(0, 32); })));
+
+  Packet* received = pool.acquire();
+  ASSERT_NE(received, nullptr);
+  IPv4Address sender;
+  bool got_packet = false;
+  debug::Timer timer;
+  while (!got_packet && timer.elapsed_sec<f64>() < 0.250) {
+    got_packet = socket_b.receive(*received, sender);
+  }
+
+  ASSERT_TRUE(got_packet);
+  EXPECT_EQ(sender, ip_a);
+  EXPECT_EQ(received->size_bytes(),
+            Packet::data_size_bytes([](auto&) {}) + sizeof(u32));
+  EXPECT_EQ(received->index(), 17);
+  EXPECT_EQ(received->receipt_index(), 4);
+  EXPECT_EQ(received->receipt_flags(), 0b11);
+
+  u32 value = 0;
+  EXPECT_TRUE(received->unpack_checked(
+      [&value](auto& unpacker) { pack(unpacker, value); }));
+  EXPECT_EQ(value, 0xdeadbeef);
+}
+
+TEST_F(SocketTests, OpenShardsBindsAllSocketsToOnePort) {
+  auto shards = Socket::open_shards(0, 4);
+  ASSERT_TRUE(shards.has_value());
+  ASSERT_EQ(shards->size(), 4);
+  EXPECT_NE(shards->front().port(), 0);
+  for (const auto& shard : *shards) {
+    EXPECT_EQ(shard.port(), shards->front().port());
+  }
+
+  // still exclusive towards sockets without SO_REUSEPORT
+  EXPECT_FALSE(Socket::open(shards->front().port()).has_value());
+}
+
+TEST_F(SocketTests, ConnectedSocketsExchangeDatagramsWithoutAddresses) {
+  auto a = open_test_socket();
+  auto b = open_test_socket();
+  auto& [ip_a, socket_a] = a;
+  auto& [ip_b, socket_b] = b;
+
+  ASSERT_TRUE(socket_a.connect(ip_b));
+  ASSERT_TRUE(socket_b.connect(ip_a));
+  EXPECT_TRUE(socket_a.connected());
+  EXPECT_EQ(socket_a.peer(), ip_b);
+
+  std::array<u8, 4> sent{1, 2, 3, 4};
+  socket_a.send(sent);
+
+  std::array<u8, 16> buffer{};
+  std::optional<u32> size;
+  debug::Timer timer;
+  while (!size && timer.elapsed_sec<f64>() < 0.250) {
+    size = socket_b.receive(buffer);
+  }
+  ASSERT_TRUE(size.has_value());
+  EXPECT_EQ(*size, sent.size());
+  EXPECT_TRUE(std::equal(sent.begin(), sent.end(), buffer.begin()));
+}
+
+TEST_F(SocketTests, ConnectedSocketDropsForeignSenders) {
+  auto client = open_test_socket();
+  auto server = open_test_socket();
+  auto stranger = open_test_socket();
+  auto& [ip_client, socket_client] = client;
+  auto& [ip_server, socket_server] = server;
+  auto& [ip_stranger, socket_stranger] = stranger;
+
+  ASSERT_TRUE(socket_client.connect(ip_server));
+
+  std::array<u8, 1> from_stranger{1};
+  std::array<u8, 1> from_server{2};
+  socket_stranger.send(ip_client, from_stranger);
+  socket_server.send(ip_client, from_server);
+
+  std::array<u8, 16> buffer{};
+  std::vector<u8> received;
+  debug::Timer timer;
+  while (timer.elapsed_sec<f64>() < 0.100) {
+    IPv4Address sender;
+    if (const auto size = socket_client.receive(buffer, sender)) {
+      EXPECT_EQ(sender, ip_server);
+      received.push_back(buffer[0]);
+    }
+  }
+  EXPECT_THAT(received, testing::ElementsAre(2));
+}
+
+/*
+ * Receives until total bytes arrived, splitting coalesced receives back into
+ * datagrams. Holds with and without GRO.
+ */
+std::vector<std::vector<u8>> receive_all_segments(Socket& socket,
+                                                  std::size_t total) {
+  std::vector<u8> buffer(Socket::kMaxSegmentedBytes);
+  std::vector<std::vector<u8>> datagrams;
+  std::size_t received = 0;
+  debug::Timer timer;
+  while (received < total && timer.elapsed_sec<f64>() < 0.250) {
+    IPv4Address sender;
+    u16 segment_size = 0;
+    const auto size = socket.receive_segments(buffer, sender, segment_size);
+    if (!size) {
+      continue;
+    }
+    for (u32 offset = 0; offset < *size; offset += segment_size) {
+      const u32 end = std::min<u32>(*size, offset + segment_size);
+      datagrams.emplace_back(buffer.begin() + offset, buffer.begin() + end);
+    }
+    received += *size;
+  }
+  return datagrams;
+}
+
+TEST_F(SocketTests, SegmentedSendArrivesAsSeparateDatagrams) {
+  auto a = open_test_socket();
+  auto b = open_test_socket();
+  auto& [ip_a, socket_a] = a;
+  auto& [ip_b, socket_b] = b;
+
+  // either may be unsupported, the datagrams must come out the same
+  socket_a.enable_gso();
+  socket_b.enable_gro();
+
+  constexpr u16 kSegmentSize = 100;
+  std::vector<u8> sent(4 * kSegmentSize + 30);
+  for (std::size_t i = 0; i < sent.size(); ++i) {
+    sent[i] = static_cast<u8>(i / kSegmentSize);
+  }
+  EXPECT_EQ(socket_a.send_segments(ip_b, sent, kSegmentSize), 5);
+
+  const auto datagrams = receive_all_segments(socket_b, sent.size());
+  ASSERT_EQ(datagrams.size(), 5);
+  for (std::size_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(datagrams[i], std::vector<u8>(kSegmentSize, i));
+  }
+  EXPECT_EQ(datagrams[4], std::vector<u8>(30, 4));
+}
+
+TEST_F(SocketTests, WithoutGso_SegmentedSendFallsBackToPlainDatagrams) {
+  auto a = open_test_socket();
+  auto b = open_test_socket();
+  auto& [ip_a, socket_a] = a;
+  auto& [ip_b, socket_b] = b;
+  EXPECT_FALSE(socket_a.gso_enabled());
+
+  std::vector<u8> sent(250, 9);
+  EXPECT_EQ(socket_a.send_segments(ip_b, sent, 100), 3);
+
+  // a plain receive() sees each one on its own
+  std::array<u8, 256> buffer{};
+  std::vector<u32> sizes;
+  debug::Timer timer;
+  while (sizes.size() < 3 && timer.elapsed_sec<f64>() < 0.250) {
+    IPv4Address sender;
+    if (const auto size = socket_b.receive(buffer, sender)) {
+      sizes.push_back(*size);
+    }
+  }
+  EXPECT_THAT(sizes, testing::ElementsAre(100, 100, 50));
+}
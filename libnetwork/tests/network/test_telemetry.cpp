@@ -0,0 +1,163 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <glue/debug/timer.hpp>
+#include <glue/network/connection.hpp>
+#include <glue/network/socket.hpp>
+#include <glue/network/telemetry.hpp>
+#include <glue/types.hpp>
+#include <thread>
+#include <vector>
+
+using namespace glue;
+using namespace glue::network;
+using namespace std::chrono_literals;
+
+namespace {
+Connection::Clock::time_point at(std::chrono::milliseconds ms) {
+  return Connection::Clock::time_point{} + ms;
+}
+}  // namespace
+
+TEST(TelemetryTests, HistogramBucketsByUpperBound) {
+  Histogram histogram{kSizeBounds};
+  histogram.record(0.0);
+  histogram.record(32.0);
+  histogram.record(33.0);
+  histogram.record(1200.0, 3);
+  histogram.record(1e9);
+
+  const auto snapshot = histogram.snapshot();
+  EXPECT_EQ(snapshot.counts[0], 2);
+  EXPECT_EQ(snapshot.counts[1], 1);
+  EXPECT_EQ(snapshot.counts[7], 3);
+  EXPECT_EQ(snapshot.counts.back(), 1);
+  EXPECT_EQ(snapshot.total(), 7);
+}
+
+TEST(TelemetryTests, PercentileIsBucketUpperBound) {
+  Histogram histogram{kRttBounds};
+  EXPECT_EQ(histogram.snapshot().percentile(0.5), 0.0);
+
+  for (int i = 0; i < 90; ++i) {
+    histogram.record(0.015);
+  }
+  for (int i = 0; i < 10; ++i) {
+    histogram.record(0.180);
+  }
+
+  const auto snapshot = histogram.snapshot();
+  EXPECT_DOUBLE_EQ(snapshot.percentile(0.5), 0.020);
+  EXPECT_DOUBLE_EQ(snapshot.percentile(0.9), 0.020);
+  EXPECT_DOUBLE_EQ(snapshot.percentile(0.99), 0.200);
+  EXPECT_DOUBLE_EQ(snapshot.percentile(1.0), 0.200);
+}
+
+TEST(TelemetryTests, SnapshotsWhileRecordingNeverGoBackwards) {
+  constexpr u32 kSamples = 100000;
+  SocketTelemetry telemetry;
+  std::atomic<bool> done{false};
+
+  std::thread recorder{[&] {
+    for (u32 i = 0; i < kSamples; ++i) {
+      telemetry.record_sent(100);
+    }
+    done = true;
+  }};
+
+  u64 last = 0;
+  while (!done) {
+    const auto stats = telemetry.snapshot();
+    EXPECT_GE(stats.packets_sent, last);
+    last = stats.packets_sent;
+  }
+  recorder.join();
+
+  const auto stats = telemetry.snapshot();
+  EXPECT_EQ(stats.packets_sent, kSamples);
+  EXPECT_EQ(stats.bytes_sent, 100ull * kSamples);
+  EXPECT_EQ(stats.sent_sizes.total(), kSamples);
+}
+
+TEST(TelemetryTests, SocketCountsDatagramsBothWays) {
+  auto a = Socket::open_any_port();
+  auto b = Socket::open_any_port();
+  ASSERT_TRUE(a.has_value() && b.has_value());
+  SocketTelemetry sent;
+  SocketTelemetry received;
+  a->set_telemetry(&sent);
+  b->set_telemetry(&received);
+  const auto address = IPv4Address::loopback(b->port());
+
+  std::array<u8, 40> small{};
+  std::array<u8, 1000> large{};
+  a->send(address, small);
+  const std::array<Datagram, 2> batch{Datagram{large, 0, address},
+                                      Datagram{large, 0, address}};
+  EXPECT_EQ(a->send_batch(batch), 2);
+
+  std::array<u8, 1500> buffer{};
+  debug::Timer timer;
+  while (received.snapshot().packets_received < 3 &&
+         timer.elapsed_sec<f64>() < 0.250) {
+    IPv4Address sender;
+    b->receive(buffer, sender);
+  }
+
+  for (const auto& stats : {sent.snapshot(), received.snapshot()}) {
+    EXPECT_EQ(stats.send_failures, 0);
+  }
+  const auto out = sent.snapshot();
+  EXPECT_EQ(out.packets_sent, 3);
+  EXPECT_EQ(out.bytes_sent, 2040);
+  EXPECT_EQ(out.sent_sizes.counts[1], 1);
+  EXPECT_EQ(out.sent_sizes.counts[6], 2);
+
+  const auto in = received.snapshot();
+  EXPECT_EQ(in.packets_received, 3);
+  EXPECT_EQ(in.bytes_received, 2040);
+  EXPECT_EQ(in.received_sizes.total(), 3);
+}
+
+TEST(TelemetryTests, ConnectionRecordsAcksLossAndRtt) {
+  Connection connection;
+  ConnectionTelemetry telemetry;
+  connection.set_telemetry(&telemetry);
+
+  for (int i = 0; i < 40; ++i) {
+    connection.next_header(at(0ms));
+  }
+  // acks 40 directly after 10ms, 1..7 fall out of the window unacked
+  EXPECT_TRUE(connection.on_receive({1, 40, 0}, at(10ms)));
+  EXPECT_FALSE(connection.on_receive({1, 40, 0}, at(10ms)));
+  telemetry.record_payload_sent(300);
+  telemetry.record_payload_received(50);
+
+  const auto stats = telemetry.snapshot();
+  EXPECT_EQ(stats.packets_sent, 40);
+  EXPECT_EQ(stats.packets_received, 1);
+  EXPECT_EQ(stats.packets_rejected, 1);
+  EXPECT_EQ(stats.packets_acked, connection.acked_count());
+  EXPECT_EQ(stats.packets_lost, connection.lost_count());
+  EXPECT_DOUBLE_EQ(stats.packet_loss, connection.packet_loss());
+  EXPECT_DOUBLE_EQ(stats.rtt, connection.rtt());
+  EXPECT_DOUBLE_EQ(stats.jitter, connection.jitter());
+  EXPECT_EQ(stats.rtt_samples.total(), 1);
+  EXPECT_DOUBLE_EQ(stats.rtt_samples.percentile(0.5), 0.010);
+  EXPECT_EQ(stats.bytes_sent, 300);
+  EXPECT_EQ(stats.bytes_received, 50);
+}
+
+TEST(TelemetryTests, DetachedConnectionStopsRecording) {
+  Connection connection;
+  ConnectionTelemetry telemetry;
+  connection.set_telemetry(&telemetry);
+  connection.next_header(at(0ms));
+  connection.set_telemetry(nullptr);
+  connection.next_header(at(0ms));
+
+  EXPECT_EQ(telemetry.snapshot().packets_sent, 1);
+  EXPECT_EQ(connection.sent_count(), 2);
+}
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <glue/network/token_bucket.hpp>
+
+using namespace glue;
+using namespace glue::network;
+using namespace std::chrono_literals;
+
+namespace {
+TokenBucket::Clock::time_point at(std::chrono::milliseconds ms) {
+  return TokenBucket::Clock::time_point{} + ms;
+}
+}  // namespace
+
+TEST(TokenBucketTests, StartsFull) {
+  TokenBucket bucket{1000.0, 500.0};
+  EXPECT_DOUBLE_EQ(bucket.available(), 500.0);
+  EXPECT_TRUE(bucket.try_consume(500.0));
+  EXPECT_FALSE(bucket.try_consume(1.0));
+}
+
+TEST(TokenBucketTests, RefillsAtRateUpToBurst) {
+  TokenBucket bucket{1000.0, 500.0};
+  bucket.refill(at(0ms));
+  ASSERT_TRUE(bucket.try_consume(500.0));
+
+  bucket.refill(at(100ms));
+  EXPECT_DOUBLE_EQ(bucket.available(), 100.0);
+
+  bucket.refill(at(10s));
+  EXPECT_DOUBLE_EQ(bucket.available(), 500.0);
+}
+
+TEST(TokenBucketTests, FailedTryConsumeSpendsNothing) {
+  TokenBucket bucket{1000.0, 100.0};
+  EXPECT_FALSE(bucket.try_consume(150.0));
+  EXPECT_DOUBLE_EQ(bucket.available(), 100.0);
+}
+
+TEST(TokenBucketTests, ConsumeDebtDelaysLaterSends) {
+  TokenBucket bucket{1000.0, 100.0};
+  bucket.refill(at(0ms));
+  bucket.consume(300.0);
+  EXPECT_DOUBLE_EQ(bucket.available(), -200.0);
+
+  bucket.refill(at(200ms));
+  EXPECT_FALSE(bucket.try_consume(1.0));
+  bucket.refill(at(250ms));
+  EXPECT_TRUE(bucket.try_consume(50.0));
+}
+
+TEST(TokenBucketTests, RateChangeAppliesFromNow) {
+  TokenBucket bucket{1000.0, 1000.0};
+  bucket.refill(at(0ms));
+  bucket.consume(1000.0);
+
+  bucket.refill(at(100ms));
+  bucket.set_rate(100.0);
+  bucket.refill(at(200ms));
+  EXPECT_DOUBLE_EQ(bucket.available(), 110.0);
+}
+
+TEST(TokenBucketTests, TimeGoingBackwardsAddsNothing) {
+  TokenBucket bucket{1000.0, 1000.0};
+  bucket.refill(at(100ms));
+  bucket.consume(1000.0);
+  bucket.refill(at(50ms));
+  EXPECT_DOUBLE_EQ(bucket.available(), 0.0);
+  bucket.refill(at(150ms));
+  EXPECT_DOUBLE_EQ(bucket.available(), 50.0);
+}